@@ -0,0 +1,97 @@
+//
+// Copyright (C) 2019 Tomasz Jankowski tomasz.jankowski.mail AT gmail.com>
+//
+// This is part of GBee library.
+//
+// GBee is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GBee is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <gbee/gbee.hpp>
+#include <vector>
+
+enum class Record
+{
+   Control,
+   Sequence,
+   Pan,
+   Destination,
+   Source
+};
+
+using namespace gbee;
+
+using RecordGroup = Group<LittleEndianField<Record::Control, std::uint16_t>,
+                          Field<Record::Sequence, std::uint8_t>,
+                          LittleEndianField<Record::Pan, std::uint16_t>,
+                          BigEndianField<Record::Destination, std::uint32_t>,
+                          BigEndianField<Record::Source, std::uint64_t>>;
+
+using RecordFrame = Frame<0, RecordGroup>;
+
+static std::vector<std::uint8_t>
+make_records(std::size_t count)
+{
+   std::vector<std::uint8_t> records(count * RecordFrame::size);
+   for(std::size_t i = 0; i < records.size(); ++i) {
+      records[i] = static_cast<std::uint8_t>(i * 7);
+   }
+   return records;
+}
+
+template<auto id>
+static void
+extract_per_frame(benchmark::State& state)
+{
+   const std::size_t count{static_cast<std::size_t>(state.range(0))};
+   const std::vector<std::uint8_t> records{make_records(count)};
+   std::vector<RecordFrame::field_value_type<id>> values(count);
+
+   for(auto _ : state) {
+      for(std::size_t i = 0; i < count; ++i) {
+         const FrameView<0, RecordGroup> view{records.data() + i * RecordFrame::size,
+                                              RecordFrame::size};
+         view.extract<id>(values[i]);
+      }
+      benchmark::DoNotOptimize(values.data());
+      benchmark::ClobberMemory();
+   }
+   state.SetItemsProcessed(state.iterations() * count);
+}
+
+template<auto id>
+static void
+extract_column(benchmark::State& state)
+{
+   const std::size_t count{static_cast<std::size_t>(state.range(0))};
+   const std::vector<std::uint8_t> records{make_records(count)};
+   std::vector<RecordFrame::field_value_type<id>> values(count);
+
+   for(auto _ : state) {
+      gbee::extract_column<RecordFrame, id>(records.data(), count, values.data());
+      benchmark::DoNotOptimize(values.data());
+      benchmark::ClobberMemory();
+   }
+   state.SetItemsProcessed(state.iterations() * count);
+}
+
+BENCHMARK_TEMPLATE(extract_per_frame, Record::Sequence)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(extract_column, Record::Sequence)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(extract_per_frame, Record::Pan)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(extract_column, Record::Pan)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(extract_per_frame, Record::Destination)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(extract_column, Record::Destination)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(extract_per_frame, Record::Source)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(extract_column, Record::Source)->Arg(1 << 16);
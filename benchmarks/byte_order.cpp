@@ -0,0 +1,132 @@
+//
+// Copyright (C) 2019 Tomasz Jankowski tomasz.jankowski.mail AT gmail.com>
+//
+// This is part of GBee library.
+//
+// GBee is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GBee is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#include <array>
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <gbee/gbee.hpp>
+
+enum class Order
+{
+   A,
+   B,
+   C
+};
+
+using namespace gbee;
+
+template<ByteOrder byte_order>
+using OrderGroup = Group<Field<Order::A, std::uint16_t, byte_order>,
+                         Field<Order::B, std::uint32_t, byte_order>,
+                         Field<Order::C, std::uint64_t, byte_order>>;
+
+template<ByteOrder byte_order>
+static void
+extract(benchmark::State& state)
+{
+   using group_type = OrderGroup<byte_order>;
+   std::array<std::uint8_t, 4096> buffer{{0}};
+   for(std::size_t i = 0; i < buffer.size(); ++i) {
+      buffer[i] = static_cast<std::uint8_t>(i);
+   }
+
+   constexpr std::size_t count{buffer.size() / group_type::size};
+   for(auto _ : state) {
+      std::uint64_t sum{0};
+      for(std::size_t i = 0; i < count; ++i) {
+         const std::uint8_t* record{buffer.data() + i * group_type::size};
+         std::uint16_t a_value;
+         std::uint32_t b_value;
+         std::uint64_t c_value;
+         group_type::template extract<Order::A>(record, group_type::size, a_value);
+         group_type::template extract<Order::B>(record, group_type::size, b_value);
+         group_type::template extract<Order::C>(record, group_type::size, c_value);
+         sum += a_value + b_value + c_value;
+      }
+      benchmark::DoNotOptimize(sum);
+   }
+   state.SetItemsProcessed(state.iterations() * count);
+}
+
+template<ByteOrder byte_order>
+static void
+inject(benchmark::State& state)
+{
+   using group_type = OrderGroup<byte_order>;
+   std::array<std::uint8_t, 4096> buffer{{0}};
+
+   constexpr std::size_t count{buffer.size() / group_type::size};
+   std::uint64_t value{0};
+   for(auto _ : state) {
+      for(std::size_t i = 0; i < count; ++i) {
+         std::uint8_t* record{buffer.data() + i * group_type::size};
+         group_type::template inject<Order::A>(record, group_type::size,
+                                               static_cast<std::uint16_t>(value));
+         group_type::template inject<Order::B>(record, group_type::size,
+                                               static_cast<std::uint32_t>(value));
+         group_type::template inject<Order::C>(record, group_type::size, value);
+         ++value;
+      }
+      benchmark::DoNotOptimize(buffer.data());
+      benchmark::ClobberMemory();
+   }
+   state.SetItemsProcessed(state.iterations() * count);
+}
+
+BENCHMARK_TEMPLATE(extract, ByteOrder::host);
+BENCHMARK_TEMPLATE(extract, ByteOrder::little);
+BENCHMARK_TEMPLATE(extract, ByteOrder::big);
+BENCHMARK_TEMPLATE(inject, ByteOrder::host);
+BENCHMARK_TEMPLATE(inject, ByteOrder::little);
+BENCHMARK_TEMPLATE(inject, ByteOrder::big);
+
+static void
+extract_array_per_element(benchmark::State& state)
+{
+   using group_type = Group<BigEndianField<Order::A, std::uint16_t>>;
+   std::array<std::uint8_t, 512> buffer{{0}};
+   std::array<std::uint16_t, 256> values{};
+
+   for(auto _ : state) {
+      for(std::size_t i = 0; i < values.size(); ++i) {
+         group_type::extract<Order::A>(buffer.data(), buffer.size(), values[i], i * 2);
+      }
+      benchmark::DoNotOptimize(values.data());
+      benchmark::ClobberMemory();
+   }
+   state.SetItemsProcessed(state.iterations() * values.size());
+}
+
+static void
+extract_array_bulk(benchmark::State& state)
+{
+   using group_type = Group<ArrayField<Order::A, std::uint16_t, 256, ByteOrder::big>>;
+   std::array<std::uint8_t, 512> buffer{{0}};
+   std::array<std::uint16_t, 256> values{};
+
+   for(auto _ : state) {
+      group_type::extract<Order::A>(buffer.data(), buffer.size(), values);
+      benchmark::DoNotOptimize(values.data());
+      benchmark::ClobberMemory();
+   }
+   state.SetItemsProcessed(state.iterations() * values.size());
+}
+
+BENCHMARK(extract_array_per_element);
+BENCHMARK(extract_array_bulk);
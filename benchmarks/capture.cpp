@@ -0,0 +1,175 @@
+//
+// Copyright (C) 2019 Tomasz Jankowski tomasz.jankowski.mail AT gmail.com>
+//
+// This is part of GBee library.
+//
+// GBee is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GBee is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#include <array>
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <filesystem>
+#include <gbee/gbee.hpp>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+enum class Record
+{
+   Timestamp,
+   Source,
+   Channel
+};
+
+using namespace gbee;
+
+using RecordGroup = Group<LittleEndianField<Record::Timestamp, std::uint64_t>,
+                          LittleEndianField<Record::Source, std::uint16_t>,
+                          Field<Record::Channel, std::uint8_t>>;
+
+using RecordFrame = Frame<0, RecordGroup>;
+
+using RecordView = FrameView<0, RecordGroup>;
+
+using PlainCapture = Capture<RecordView, IndexFields<Record::Timestamp, Record::Source>>;
+
+using DeltaCapture = Capture<RecordView,
+                             IndexFields<Record::Timestamp, Record::Source>,
+                             DeltaFields<Record::Timestamp, Record::Channel>>;
+
+static constexpr std::size_t payload_length{40};
+
+static constexpr std::size_t frame_count{4096};
+
+static constexpr std::uint64_t recorded_frames{std::uint64_t{1} << 18};
+
+static constexpr std::uint64_t first_timestamp{1'600'000'000'000'000};
+
+static const std::filesystem::path directory{std::filesystem::temp_directory_path() /
+                                             ("gbee-capture-" + std::to_string(::getpid()))};
+
+// Frames from 64 sources, 250 microseconds apart, on a channel that rarely changes.
+static std::array<std::uint8_t, RecordFrame::size + payload_length>
+make_frame(std::uint64_t i)
+{
+   std::array<std::uint8_t, RecordFrame::size + payload_length> buffer{};
+   RecordFrame frame{buffer.data(), buffer.size()};
+   frame.inject<Record::Timestamp>(first_timestamp + i * 250);
+   frame.inject<Record::Source>(static_cast<std::uint16_t>(i * 13 % 64));
+   frame.inject<Record::Channel>(static_cast<std::uint8_t>(11 + i / 100'000 % 16));
+   for(std::size_t j = 0; j < payload_length; ++j) {
+      buffer[RecordFrame::size + j] = static_cast<std::uint8_t>(i + j);
+   }
+   return buffer;
+}
+
+template<typename CaptureType>
+static void
+capture_ingest(benchmark::State& state)
+{
+   std::vector<std::array<std::uint8_t, RecordFrame::size + payload_length>> frames;
+   for(std::size_t i = 0; i < frame_count; ++i) {
+      frames.push_back(make_frame(i));
+   }
+
+   const std::filesystem::path ingest{directory / "ingest"};
+   std::filesystem::remove_all(ingest);
+   {
+      typename CaptureType::Writer writer{ingest};
+      for(auto _ : state) {
+         for(auto& buffer : frames) {
+            writer.append(RecordFrame{buffer.data(), buffer.size()}, payload_length);
+         }
+      }
+   }
+   std::uintmax_t written{0};
+   for(const std::filesystem::path& segment : CaptureType::segments(ingest)) {
+      written += std::filesystem::file_size(segment);
+   }
+   std::filesystem::remove_all(ingest);
+
+   state.SetItemsProcessed(state.iterations() * frame_count);
+   state.SetBytesProcessed(state.iterations() * frame_count * (RecordFrame::size + payload_length));
+   state.counters["stored"] =
+     static_cast<double>(written) / (state.iterations() * frame_count * frames[0].size());
+}
+
+// One segment of recorded_frames frames, about 65 seconds of traffic. The file is unlinked
+// once mapped.
+template<typename CaptureType>
+static const typename CaptureType::Reader&
+recorded()
+{
+   static const typename CaptureType::Reader reader{[] {
+      const std::filesystem::path recording{directory / "recorded"};
+      std::filesystem::remove_all(recording);
+      typename CaptureType::Writer writer{recording, 256, std::size_t{1} << 30};
+      for(std::uint64_t i = 0; i < recorded_frames; ++i) {
+         auto buffer{make_frame(i)};
+         writer.append(RecordFrame{buffer.data(), buffer.size()}, payload_length);
+      }
+      writer.close();
+      return CaptureType::segments(recording)[0];
+   }()};
+   std::filesystem::remove_all(directory);
+   return reader;
+}
+
+static constexpr std::uint64_t query_window{100'000};
+
+// One source over a 100 ms window, moving through the recording.
+template<typename CaptureType>
+static void
+capture_select(benchmark::State& state)
+{
+   const typename CaptureType::Reader& reader{recorded<CaptureType>()};
+   std::uint64_t start{first_timestamp};
+   std::size_t matched{0};
+   for(auto _ : state) {
+      matched += reader.select([](const RecordView& frame) { benchmark::DoNotOptimize(frame); },
+                               between<Record::Timestamp>(start, start + query_window),
+                               equal_to<Record::Source>(std::uint16_t{7}));
+      start = first_timestamp + (start - first_timestamp + 7'777'777) % (recorded_frames * 250);
+   }
+   state.counters["matched"] = static_cast<double>(matched) / state.iterations();
+}
+
+// The same query checking every frame.
+template<typename CaptureType>
+static void
+capture_scan(benchmark::State& state)
+{
+   const typename CaptureType::Reader& reader{recorded<CaptureType>()};
+   std::uint64_t start{first_timestamp};
+   std::size_t matched{0};
+   for(auto _ : state) {
+      reader.for_each([&](const RecordView& frame) {
+         std::uint64_t timestamp;
+         std::uint16_t source;
+         frame.extract<Record::Timestamp>(timestamp);
+         frame.extract<Record::Source>(source);
+         matched += timestamp >= start && timestamp <= start + query_window && source == 7;
+      });
+      start = first_timestamp + (start - first_timestamp + 7'777'777) % (recorded_frames * 250);
+   }
+   state.counters["matched"] = static_cast<double>(matched) / state.iterations();
+}
+
+BENCHMARK_TEMPLATE(capture_ingest, PlainCapture);
+BENCHMARK_TEMPLATE(capture_ingest, DeltaCapture);
+BENCHMARK_TEMPLATE(capture_select, PlainCapture);
+BENCHMARK_TEMPLATE(capture_select, DeltaCapture);
+BENCHMARK_TEMPLATE(capture_scan, PlainCapture);
+BENCHMARK_TEMPLATE(capture_scan, DeltaCapture);
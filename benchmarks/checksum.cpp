@@ -0,0 +1,83 @@
+//
+// Copyright (C) 2019 Tomasz Jankowski tomasz.jankowski.mail AT gmail.com>
+//
+// This is part of GBee library.
+//
+// GBee is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GBee is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#include <array>
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <gbee/gbee.hpp>
+
+enum class Mac
+{
+   Control,
+   Sequence,
+   Body
+};
+
+enum class Trailer
+{
+   Fcs
+};
+
+using namespace gbee;
+
+template<typename Algorithm>
+using MacFrame = Frame<0,
+                       Group<LittleEndianField<Mac::Control, std::uint16_t>,
+                             Field<Mac::Sequence, std::uint8_t>,
+                             ArrayField<Mac::Body, std::uint8_t, 112>>,
+                       Group<Checksum<Trailer::Fcs, Algorithm>>>;
+
+template<typename Algorithm>
+static void
+update_checksum(benchmark::State& state)
+{
+   std::array<std::uint8_t, MacFrame<Algorithm>::size> buffer{};
+   MacFrame<Algorithm> frame{buffer};
+   std::uint8_t sequence{0};
+
+   for(auto _ : state) {
+      frame.template inject<Mac::Sequence>(sequence++);
+      frame.template update_checksum<Trailer::Fcs>();
+      benchmark::DoNotOptimize(buffer.data());
+      benchmark::ClobberMemory();
+   }
+   state.SetBytesProcessed(state.iterations() * buffer.size());
+}
+
+template<typename Algorithm>
+static void
+inject_incremental(benchmark::State& state)
+{
+   std::array<std::uint8_t, MacFrame<Algorithm>::size> buffer{};
+   MacFrame<Algorithm> frame{buffer};
+   frame.template update_checksum<Trailer::Fcs>();
+   std::uint8_t sequence{0};
+
+   for(auto _ : state) {
+      frame.template inject_incremental<Mac::Sequence, Trailer::Fcs>(sequence++);
+      benchmark::DoNotOptimize(buffer.data());
+      benchmark::ClobberMemory();
+   }
+   state.SetBytesProcessed(state.iterations() * buffer.size());
+}
+
+BENCHMARK_TEMPLATE(update_checksum, Crc16Kermit);
+BENCHMARK_TEMPLATE(inject_incremental, Crc16Kermit);
+BENCHMARK_TEMPLATE(update_checksum, Crc32c);
+BENCHMARK_TEMPLATE(inject_incremental, Crc32c);
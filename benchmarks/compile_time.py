@@ -0,0 +1,98 @@
+#!/usr/bin/env python3
+#
+# Copyright (C) 2019 Tomasz Jankowski tomasz.jankowski.mail AT gmail.com>
+#
+# This is part of GBee library.
+#
+# GBee is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# GBee is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see http://www.gnu.org/licenses/.
+#
+
+"""Generates schemas with a growing number of fields and measures how long a
+translation unit using every field takes to compile and how much memory the
+compiler needs. Fields go either into one group ('flat') or into groups of ten
+('grouped'). With --syntax-only code generation is skipped, which isolates the cost of
+the template machinery from the cost of emitting every instantiated function."""
+
+import argparse
+import os
+import subprocess
+import sys
+import tempfile
+import time
+
+FIELD_TYPES = ['std::uint8_t', 'std::uint16_t', 'std::uint32_t', 'std::uint64_t']
+
+
+def generate(field_count, group_size):
+    group_count = (field_count + group_size - 1) // group_size
+    lines = ['#include <cstdint>', '#include <gbee/gbee.hpp>', '', 'using namespace gbee;', '']
+    groups = []
+    for group in range(group_count):
+        fields = range(group * group_size, min(field_count, (group + 1) * group_size))
+        lines.append('enum class Id%d {%s};' % (group, ', '.join('F%d' % f for f in fields)))
+        lines.append('using Group%d = Group<%s>;' % (group, ', '.join(
+            'LittleEndianField<Id%d::F%d, %s>' % (group, f, FIELD_TYPES[f % len(FIELD_TYPES)])
+            for f in fields)))
+        groups.append((group, fields))
+
+    lines.append('using Schema = Frame<0, %s>;' % ', '.join('Group%d' % g for g, _ in groups))
+    lines += ['', 'std::uint64_t', 'touch(std::uint8_t* buffer)', '{',
+              '   Schema frame{buffer, Schema::size};', '   std::uint64_t sum{0};']
+    for group, fields in groups:
+        for f in fields:
+            field_type = FIELD_TYPES[f % len(FIELD_TYPES)]
+            lines.append('   frame.inject<Id%d::F%d>(%s{%d});' % (group, f, field_type, f % 200))
+            lines.append('   { %s value{}; frame.extract<Id%d::F%d>(value); sum += value; }'
+                         % (field_type, group, f))
+    lines += ['   return sum;', '}', '']
+    return '\n'.join(lines)
+
+
+def measure(compiler, flags, source):
+    with tempfile.TemporaryDirectory() as directory:
+        path = os.path.join(directory, 'schema.cpp')
+        with open(path, 'w') as output:
+            output.write(source)
+        start = time.monotonic()
+        process = subprocess.Popen([compiler] + flags + ['-c', path, '-o', os.devnull])
+        _, status, usage = os.wait4(process.pid, 0)
+        elapsed = time.monotonic() - start
+        if os.waitstatus_to_exitcode(status) != 0:
+            sys.exit('compilation failed')
+        return elapsed, usage.ru_maxrss / 1024
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('--compiler', default=os.environ.get('CXX', 'c++'))
+    parser.add_argument('--include', required=True, help='gbee include directory')
+    parser.add_argument('--sizes', type=int, nargs='+', default=[10, 50, 100, 250, 500, 1000])
+    parser.add_argument('--shapes', nargs='+', choices=['flat', 'grouped'],
+                        default=['flat', 'grouped'])
+    parser.add_argument('--syntax-only', action='store_true')
+    arguments = parser.parse_args()
+
+    flags = ['-std=c++17', '-O0', '-I', arguments.include]
+    if arguments.syntax_only:
+        flags.append('-fsyntax-only')
+    print('%-8s %8s %10s %10s' % ('shape', 'fields', 'seconds', 'MiB'))
+    for shape in arguments.shapes:
+        for size in arguments.sizes:
+            group_size = size if shape == 'flat' else 10
+            seconds, memory = measure(arguments.compiler, flags, generate(size, group_size))
+            print('%-8s %8d %10.2f %10.1f' % (shape, size, seconds, memory), flush=True)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,116 @@
+//
+// Copyright (C) 2019 Tomasz Jankowski tomasz.jankowski.mail AT gmail.com>
+//
+// This is part of GBee library.
+//
+// GBee is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GBee is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#include <array>
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <gbee/gbee.hpp>
+#include <unordered_map>
+#include <vector>
+
+enum class Nwk
+{
+   Control,
+   Destination,
+   Source,
+   Radius,
+   Sequence
+};
+
+using namespace gbee;
+
+using NwkGroup = Group<LittleEndianField<Nwk::Control, std::uint16_t>,
+                       LittleEndianField<Nwk::Destination, std::uint16_t>,
+                       LittleEndianField<Nwk::Source, std::uint16_t>,
+                       Field<Nwk::Radius, std::uint8_t>,
+                       Field<Nwk::Sequence, std::uint8_t>>;
+
+using NwkFrame = Frame<0, NwkGroup>;
+
+using NwkView = FrameView<0, NwkGroup>;
+
+static constexpr std::uint32_t window{1000};
+
+static constexpr std::size_t frame_count{4096};
+
+// Every broadcast arrives three times, from 256 sources with a running sequence number.
+static std::vector<std::array<std::uint8_t, NwkFrame::size>>
+make_traffic()
+{
+   std::vector<std::array<std::uint8_t, NwkFrame::size>> buffers(frame_count);
+   for(std::size_t i = 0; i < frame_count; ++i) {
+      const std::size_t broadcast{i / 3};
+      NwkFrame frame{buffers[i].data(), buffers[i].size()};
+      frame.inject<Nwk::Source>(static_cast<std::uint16_t>(broadcast * 37 % 256));
+      frame.inject<Nwk::Sequence>(static_cast<std::uint8_t>(broadcast / 256));
+   }
+   return buffers;
+}
+
+static const std::vector<std::array<std::uint8_t, NwkFrame::size>> traffic{make_traffic()};
+
+static void
+dedup_unordered_map(benchmark::State& state)
+{
+   std::unordered_map<std::uint32_t, std::uint32_t> seen;
+   std::uint32_t now{0};
+   std::size_t accepted{0};
+   for(auto _ : state) {
+      for(const auto& buffer : traffic) {
+         const NwkView frame{buffer.data(), buffer.size()};
+         std::uint16_t source;
+         std::uint8_t sequence;
+         frame.extract<Nwk::Source>(source);
+         frame.extract<Nwk::Sequence>(sequence);
+         const auto inserted{seen.emplace(std::uint32_t{source} << 8 | sequence, now)};
+         if(inserted.second || now - inserted.first->second >= window) {
+            inserted.first->second = now;
+            ++accepted;
+         }
+         ++now;
+         if(now % window == 0) {
+            for(auto entry = seen.begin(); entry != seen.end();) {
+               entry = now - entry->second >= window ? seen.erase(entry) : std::next(entry);
+            }
+         }
+      }
+   }
+   benchmark::DoNotOptimize(accepted);
+   state.SetItemsProcessed(state.iterations() * frame_count);
+}
+
+static void
+dedup_table(benchmark::State& state)
+{
+   static DuplicateTable<NwkFrame, 2048, Nwk::Source, Nwk::Sequence> table{window};
+   std::uint32_t now{0};
+   std::size_t accepted{0};
+   for(auto _ : state) {
+      for(const auto& buffer : traffic) {
+         const NwkView frame{buffer.data(), buffer.size()};
+         accepted += table.insert(frame, now++);
+      }
+   }
+   benchmark::DoNotOptimize(accepted);
+   state.SetItemsProcessed(state.iterations() * frame_count);
+}
+
+BENCHMARK(dedup_unordered_map);
+BENCHMARK(dedup_table);
+BENCHMARK(dedup_table)->Threads(4);
@@ -0,0 +1,296 @@
+//
+// Copyright (C) 2019 Tomasz Jankowski tomasz.jankowski.mail AT gmail.com>
+//
+// This is part of GBee library.
+//
+// GBee is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GBee is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <cstring>
+#include <gbee/gbee.hpp>
+#include <utility>
+#include <vector>
+
+using namespace gbee;
+
+// Frame accessors compared against hand-written code writing the same little endian layout.
+enum class Layout
+{
+   frame,
+   packed,
+   memcpy
+};
+
+template<std::size_t group>
+struct Slot
+{
+   enum class Id
+   {
+      A,
+      B,
+      C,
+      D
+   };
+};
+
+template<typename T, std::size_t group>
+using SlotGroup = Group<LittleEndianField<Slot<group>::Id::A, T>,
+                        LittleEndianField<Slot<group>::Id::B, T>,
+                        LittleEndianField<Slot<group>::Id::C, T>,
+                        LittleEndianField<Slot<group>::Id::D, T>>;
+
+template<typename T, typename Groups>
+struct slot_frame;
+
+template<typename T, std::size_t... groups>
+struct slot_frame<T, std::index_sequence<groups...>>
+{
+   using type = Frame<0, SlotGroup<T, groups>...>;
+   using view_type = FrameView<0, SlotGroup<T, groups>...>;
+};
+
+template<typename T, std::size_t group_count>
+using SlotFrame = typename slot_frame<T, std::make_index_sequence<group_count>>::type;
+
+template<typename T, std::size_t group_count>
+using SlotFrameView = typename slot_frame<T, std::make_index_sequence<group_count>>::view_type;
+
+template<typename T, std::size_t group_count>
+struct __attribute__((packed)) PackedRecord
+{
+   struct __attribute__((packed))
+   {
+      T a;
+      T b;
+      T c;
+      T d;
+   } groups[group_count];
+};
+
+template<typename T, std::size_t... groups>
+static void
+inject_frame(SlotFrame<T, sizeof...(groups)>& frame, T value, std::index_sequence<groups...>)
+{
+   ((frame.template inject<Slot<groups>::Id::A>(value),
+     frame.template inject<Slot<groups>::Id::B>(static_cast<T>(value + 1)),
+     frame.template inject<Slot<groups>::Id::C>(static_cast<T>(value + 2)),
+     frame.template inject<Slot<groups>::Id::D>(static_cast<T>(value + 3))),
+    ...);
+}
+
+template<typename T, std::size_t... groups>
+static std::uint64_t
+extract_frame(const SlotFrameView<T, sizeof...(groups)>& frame, std::index_sequence<groups...>)
+{
+   std::uint64_t sum{0};
+   const auto add{[&sum](T value) { sum += value; }};
+   T value;
+   ((frame.template extract<Slot<groups>::Id::A>(value), add(value),
+     frame.template extract<Slot<groups>::Id::B>(value), add(value),
+     frame.template extract<Slot<groups>::Id::C>(value), add(value),
+     frame.template extract<Slot<groups>::Id::D>(value), add(value)),
+    ...);
+   return sum;
+}
+
+template<Layout layout, typename T, std::size_t group_count>
+static void
+inject_record(std::uint8_t* record, T value)
+{
+   if constexpr(layout == Layout::frame) {
+      SlotFrame<T, group_count> frame{record, SlotFrame<T, group_count>::size};
+      inject_frame<T>(frame, value, std::make_index_sequence<group_count>{});
+   }
+   else if constexpr(layout == Layout::packed) {
+      auto& packed{*reinterpret_cast<PackedRecord<T, group_count>*>(record)};
+      for(std::size_t group = 0; group < group_count; ++group) {
+         packed.groups[group].a = value;
+         packed.groups[group].b = static_cast<T>(value + 1);
+         packed.groups[group].c = static_cast<T>(value + 2);
+         packed.groups[group].d = static_cast<T>(value + 3);
+      }
+   }
+   else {
+      for(std::size_t group = 0; group < group_count; ++group) {
+         for(std::size_t field = 0; field < 4; ++field) {
+            const T field_value{static_cast<T>(value + field)};
+            std::memcpy(record + (group * 4 + field) * sizeof(T), &field_value, sizeof(T));
+         }
+      }
+   }
+}
+
+template<Layout layout, typename T, std::size_t group_count>
+static std::uint64_t
+extract_record(const std::uint8_t* record)
+{
+   if constexpr(layout == Layout::frame) {
+      const SlotFrameView<T, group_count> frame{record, SlotFrameView<T, group_count>::size};
+      return extract_frame<T>(frame, std::make_index_sequence<group_count>{});
+   }
+   else if constexpr(layout == Layout::packed) {
+      const auto& packed{*reinterpret_cast<const PackedRecord<T, group_count>*>(record)};
+      std::uint64_t sum{0};
+      for(std::size_t group = 0; group < group_count; ++group) {
+         sum += std::uint64_t{packed.groups[group].a} + packed.groups[group].b +
+                packed.groups[group].c + packed.groups[group].d;
+      }
+      return sum;
+   }
+   else {
+      std::uint64_t sum{0};
+      for(std::size_t field = 0; field < group_count * 4; ++field) {
+         T value;
+         std::memcpy(&value, record + field * sizeof(T), sizeof(T));
+         sum += value;
+      }
+      return sum;
+   }
+}
+
+template<typename T, std::size_t group_count>
+static constexpr std::size_t record_size{sizeof(T) * 4 * group_count};
+
+// The argument is the misalignment of every record relative to the natural alignment of T.
+template<Layout layout, typename T, std::size_t group_count>
+static void
+inject(benchmark::State& state)
+{
+   constexpr std::size_t stride{record_size<T, group_count> + alignof(std::max_align_t)};
+   const std::size_t misalignment{static_cast<std::size_t>(state.range(0))};
+   const std::size_t count{(1 << 16) / stride};
+   std::vector<std::uint8_t> buffer(count * stride + alignof(std::max_align_t));
+
+   T value{0};
+   for(auto _ : state) {
+      for(std::size_t i = 0; i < count; ++i) {
+         inject_record<layout, T, group_count>(buffer.data() + i * stride + misalignment, value);
+         ++value;
+      }
+      benchmark::ClobberMemory();
+   }
+   state.SetBytesProcessed(state.iterations() * count * record_size<T, group_count>);
+}
+
+template<Layout layout, typename T, std::size_t group_count>
+static void
+extract(benchmark::State& state)
+{
+   constexpr std::size_t stride{record_size<T, group_count> + alignof(std::max_align_t)};
+   const std::size_t misalignment{static_cast<std::size_t>(state.range(0))};
+   const std::size_t count{(1 << 16) / stride};
+   std::vector<std::uint8_t> buffer(count * stride + alignof(std::max_align_t));
+   for(std::size_t i = 0; i < buffer.size(); ++i) {
+      buffer[i] = static_cast<std::uint8_t>(i * 7);
+   }
+
+   for(auto _ : state) {
+      std::uint64_t sum{0};
+      for(std::size_t i = 0; i < count; ++i) {
+         sum += extract_record<layout, T, group_count>(buffer.data() + i * stride + misalignment);
+      }
+      benchmark::DoNotOptimize(sum);
+   }
+   state.SetBytesProcessed(state.iterations() * count * record_size<T, group_count>);
+}
+
+#define GBEE_LAYOUT_BENCHMARK(function, type, group_count)                                       \
+   BENCHMARK_TEMPLATE(function, Layout::frame, type, group_count)->Arg(0)->Arg(1);               \
+   BENCHMARK_TEMPLATE(function, Layout::packed, type, group_count)->Arg(0)->Arg(1);              \
+   BENCHMARK_TEMPLATE(function, Layout::memcpy, type, group_count)->Arg(0)->Arg(1)
+
+GBEE_LAYOUT_BENCHMARK(inject, std::uint8_t, 1);
+GBEE_LAYOUT_BENCHMARK(inject, std::uint16_t, 1);
+GBEE_LAYOUT_BENCHMARK(inject, std::uint32_t, 1);
+GBEE_LAYOUT_BENCHMARK(inject, std::uint64_t, 1);
+GBEE_LAYOUT_BENCHMARK(inject, std::uint32_t, 4);
+GBEE_LAYOUT_BENCHMARK(inject, std::uint32_t, 16);
+GBEE_LAYOUT_BENCHMARK(extract, std::uint8_t, 1);
+GBEE_LAYOUT_BENCHMARK(extract, std::uint16_t, 1);
+GBEE_LAYOUT_BENCHMARK(extract, std::uint32_t, 1);
+GBEE_LAYOUT_BENCHMARK(extract, std::uint64_t, 1);
+GBEE_LAYOUT_BENCHMARK(extract, std::uint32_t, 4);
+GBEE_LAYOUT_BENCHMARK(extract, std::uint32_t, 16);
+
+// inject_all against the same header injected one field at a time; the copy plan merges the 11
+// fields of the 20 byte header into 3 stores.
+enum class Ipv4
+{
+   Version,
+   Length,
+   Service,
+   Total,
+   Identification,
+   Fragment,
+   Ttl,
+   Protocol,
+   Checksum,
+   Source,
+   Destination
+};
+
+using Ipv4Group = Group<BitField<Ipv4::Version, std::uint8_t, 4>,
+                        BitField<Ipv4::Length, std::uint8_t, 4>,
+                        Field<Ipv4::Service, std::uint8_t>,
+                        BigEndianField<Ipv4::Total, std::uint16_t>,
+                        BigEndianField<Ipv4::Identification, std::uint16_t>,
+                        BigEndianField<Ipv4::Fragment, std::uint16_t>,
+                        Field<Ipv4::Ttl, std::uint8_t>,
+                        Field<Ipv4::Protocol, std::uint8_t>,
+                        BigEndianField<Ipv4::Checksum, std::uint16_t>,
+                        BigEndianField<Ipv4::Source, std::uint32_t>,
+                        BigEndianField<Ipv4::Destination, std::uint32_t>>;
+
+using Ipv4Frame = Frame<0, Ipv4Group>;
+
+template<std::size_t... indexes>
+static void
+inject_fields(Ipv4Frame& frame,
+              const Ipv4Frame::values_type& values,
+              std::index_sequence<indexes...>)
+{
+   (frame.inject<std::tuple_element_t<indexes, Ipv4Frame::fields_type>::id>(
+      std::get<indexes>(values)),
+    ...);
+}
+
+template<bool all>
+static void
+inject_header(benchmark::State& state)
+{
+   constexpr std::size_t count{(1 << 16) / Ipv4Frame::size};
+   std::vector<std::uint8_t> buffer(count * Ipv4Frame::size);
+   Ipv4Frame::values_type values{4, 5, 0, 20, 0, 0x4000, 64, 17, 0, 0x0a000001, 0x0a000002};
+
+   for(auto _ : state) {
+      for(std::size_t i = 0; i < count; ++i) {
+         Ipv4Frame frame{buffer.data() + i * Ipv4Frame::size, Ipv4Frame::size};
+         std::get<4>(values) = static_cast<std::uint16_t>(i);
+         if constexpr(all) {
+            frame.inject_all(values);
+         }
+         else {
+            inject_fields(frame, values, std::make_index_sequence<Ipv4Group::field_count>{});
+         }
+      }
+      benchmark::ClobberMemory();
+   }
+   state.SetBytesProcessed(state.iterations() * count * Ipv4Frame::size);
+}
+
+BENCHMARK_TEMPLATE(inject_header, false);
+BENCHMARK_TEMPLATE(inject_header, true);
@@ -0,0 +1,71 @@
+//
+// Copyright (C) 2019 Tomasz Jankowski tomasz.jankowski.mail AT gmail.com>
+//
+// This is part of GBee library.
+//
+// GBee is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GBee is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#include <array>
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <gbee/gbee.hpp>
+#include <vector>
+
+enum class Nwk
+{
+   Control,
+   Destination,
+   Source,
+   Radius,
+   Sequence
+};
+
+using namespace gbee;
+
+using NwkGroup = Group<LittleEndianField<Nwk::Control, std::uint16_t>,
+                       LittleEndianField<Nwk::Destination, std::uint16_t>,
+                       LittleEndianField<Nwk::Source, std::uint16_t>,
+                       Field<Nwk::Radius, std::uint8_t>,
+                       Field<Nwk::Sequence, std::uint8_t>>;
+
+static constexpr std::size_t frame_count{1024};
+
+static const std::vector<std::array<std::uint8_t, NwkGroup::size>> traffic(frame_count);
+
+// Reads three fields of every frame through FrameType.
+template<typename FrameType>
+static void
+extract_fields(benchmark::State& state)
+{
+   for(auto _ : state) {
+      std::uint32_t sum{0};
+      for(const auto& buffer : traffic) {
+         const FrameType frame{buffer};
+         std::uint16_t source;
+         std::uint8_t radius;
+         std::uint8_t sequence;
+         frame.template extract<Nwk::Source>(source);
+         frame.template extract<Nwk::Radius>(radius);
+         frame.template extract<Nwk::Sequence>(sequence);
+         sum += source + radius + sequence;
+      }
+      benchmark::DoNotOptimize(sum);
+   }
+   state.SetItemsProcessed(state.iterations() * frame_count);
+}
+
+BENCHMARK_TEMPLATE(extract_fields, FrameView<0, NwkGroup>);
+BENCHMARK_TEMPLATE(extract_fields, InstrumentedFrameView<FieldCounters<>, 0, NwkGroup>);
+BENCHMARK_TEMPLATE(extract_fields, InstrumentedFrameView<FieldCounters<1024>, 0, NwkGroup>);
@@ -0,0 +1,81 @@
+//
+// Copyright (C) 2019 Tomasz Jankowski tomasz.jankowski.mail AT gmail.com>
+//
+// This is part of GBee library.
+//
+// GBee is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GBee is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#include <array>
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <gbee/gbee.hpp>
+#include <vector>
+
+enum class Mac
+{
+   Control,
+   Counter,
+   Pan,
+   Address,
+   Hops
+};
+
+using namespace gbee;
+
+using MacGroup = Group<Field<Mac::Control, std::uint8_t>,
+                       Field<Mac::Counter, std::uint32_t>,
+                       Field<Mac::Pan, std::uint16_t>,
+                       Field<Mac::Address, std::uint64_t>,
+                       ArrayField<Mac::Hops, std::uint16_t, 3>>;
+
+using WireView = FrameView<0, MacGroup>;
+
+using InternalView = AlignedFrameView<8, 0, ReorderedGroup<MacGroup>>;
+
+static constexpr std::size_t frame_count{1024};
+
+struct alignas(8) Slot
+{
+   std::array<std::uint8_t, 24> bytes;
+};
+
+static const std::vector<Slot> slots(frame_count);
+
+// Reads the multi-byte fields of frames in 8-byte aligned slots, misaligned in the wire order
+// and aligned in the reordered one.
+template<typename FrameType>
+static void
+extract_layout(benchmark::State& state)
+{
+   static_assert(FrameType::size <= sizeof(Slot));
+   for(auto _ : state) {
+      std::uint64_t sum{0};
+      for(const Slot& slot : slots) {
+         const FrameType frame{slot.bytes};
+         std::uint32_t counter;
+         std::uint16_t pan;
+         std::uint64_t address;
+         frame.template extract<Mac::Counter>(counter);
+         frame.template extract<Mac::Pan>(pan);
+         frame.template extract<Mac::Address>(address);
+         sum += counter + pan + address;
+      }
+      benchmark::DoNotOptimize(sum);
+   }
+   state.SetItemsProcessed(state.iterations() * frame_count);
+}
+
+BENCHMARK_TEMPLATE(extract_layout, WireView);
+BENCHMARK_TEMPLATE(extract_layout, InternalView);
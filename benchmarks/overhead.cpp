@@ -0,0 +1,105 @@
+//
+// Copyright (C) 2019 Tomasz Jankowski tomasz.jankowski.mail AT gmail.com>
+//
+// This is part of GBee library.
+//
+// GBee is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GBee is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <string>
+#include <vector>
+
+// Runs the layout benchmarks and fails when a frame accessor is slower than the packed struct
+// baseline by more than the tolerance. Use --benchmark_repetitions to damp the noise; the
+// fastest repetition of each case is compared, or the median when only aggregates are reported.
+class OverheadReporter : public benchmark::ConsoleReporter
+{
+ public:
+   void
+   ReportRuns(const std::vector<Run>& reports) override
+   {
+      ConsoleReporter::ReportRuns(reports);
+      for(const Run& run : reports) {
+         if(run.error_occurred ||
+            (run.run_type == Run::RT_Aggregate && run.aggregate_name != "median")) {
+            continue;
+         }
+         const auto [time, inserted]{
+           times.emplace(run.run_name.str(), std::numeric_limits<double>::infinity())};
+         static_cast<void>(inserted);
+         time->second = std::min(time->second, run.GetAdjustedCPUTime());
+      }
+   }
+
+   std::map<std::string, double> times;
+};
+
+static bool
+check_overhead(const std::map<std::string, double>& times, double tolerance)
+{
+   static constexpr char frame[]{"Layout::frame"};
+   static constexpr char packed[]{"Layout::packed"};
+
+   bool passed{true};
+   std::printf("\n%-50s %10s\n", "frame / packed", "ratio");
+   for(const auto& [name, time] : times) {
+      const std::size_t position{name.find(frame)};
+      if(position == std::string::npos) {
+         continue;
+      }
+
+      const std::string baseline{std::string{name}.replace(position, std::strlen(frame), packed)};
+      const auto baseline_time{times.find(baseline)};
+      if(baseline_time == times.end()) {
+         continue;
+      }
+
+      const double ratio{time / baseline_time->second};
+      const bool within{ratio <= tolerance};
+      std::printf("%-50s %10.3f%s\n", name.c_str(), ratio, within ? "" : "  <-- over tolerance");
+      passed = passed && within;
+   }
+   return passed;
+}
+
+int
+main(int argc, char** argv)
+{
+   benchmark::Initialize(&argc, argv);
+
+   double tolerance{1.25};
+   static constexpr char tolerance_flag[]{"--overhead_tolerance="};
+   for(int i = 1; i < argc; ++i) {
+      if(std::strncmp(argv[i], tolerance_flag, std::strlen(tolerance_flag)) == 0) {
+         tolerance = std::atof(argv[i] + std::strlen(tolerance_flag));
+      }
+      else {
+         std::fprintf(stderr, "%s: unrecognized argument '%s'\n", argv[0], argv[i]);
+         return 1;
+      }
+   }
+
+   OverheadReporter reporter;
+   benchmark::RunSpecifiedBenchmarks(&reporter);
+   benchmark::Shutdown();
+   return check_overhead(reporter.times, tolerance) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
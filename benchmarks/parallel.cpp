@@ -0,0 +1,70 @@
+//
+// Copyright (C) 2019 Tomasz Jankowski tomasz.jankowski.mail AT gmail.com>
+//
+// This is part of GBee library.
+//
+// GBee is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GBee is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <gbee/gbee.hpp>
+#include <new>
+#include <thread>
+#include <vector>
+
+enum class Record
+{
+   Control,
+   Sequence,
+   Pan,
+   Destination,
+   Source
+};
+
+using namespace gbee;
+
+using RecordFrame = Frame<0,
+                          Group<LittleEndianField<Record::Control, std::uint16_t>,
+                                Field<Record::Sequence, std::uint8_t>,
+                                LittleEndianField<Record::Pan, std::uint16_t>,
+                                BigEndianField<Record::Destination, std::uint32_t>,
+                                BigEndianField<Record::Source, std::uint64_t>>>;
+
+static void
+encode_batch(benchmark::State& state)
+{
+   const std::size_t count{1 << 22};
+   std::vector<RecordFrame::values_type> values(count);
+   for(std::size_t i = 0; i < count; ++i) {
+      values[i] = {0x8841, static_cast<std::uint8_t>(i), 0xabcd, static_cast<std::uint32_t>(i), i};
+   }
+   std::uint8_t* output{static_cast<std::uint8_t*>(
+     ::operator new(count * RecordFrame::size, std::align_val_t{64}))};
+   ThreadPool pool{static_cast<std::size_t>(state.range(0))};
+
+   for(auto _ : state) {
+      gbee::encode_batch<RecordFrame>(pool, values.data(), count, output);
+      benchmark::ClobberMemory();
+   }
+   ::operator delete(output, std::align_val_t{64});
+   state.SetItemsProcessed(state.iterations() * count);
+   state.SetBytesProcessed(state.iterations() * count * RecordFrame::size);
+}
+
+BENCHMARK(encode_batch)
+  ->RangeMultiplier(2)
+  ->Range(1, std::max(1u, std::thread::hardware_concurrency()))
+  ->UseRealTime()
+  ->Unit(benchmark::kMillisecond);
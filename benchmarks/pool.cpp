@@ -0,0 +1,98 @@
+//
+// Copyright (C) 2019 Tomasz Jankowski tomasz.jankowski.mail AT gmail.com>
+//
+// This is part of GBee library.
+//
+// GBee is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GBee is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#include <array>
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <cstdlib>
+#include <gbee/gbee.hpp>
+#include <optional>
+
+enum class Header
+{
+   Type,
+   Sequence
+};
+
+using namespace gbee;
+
+using PoolFrame =
+  Frame<120, Group<Field<Header::Type, std::uint8_t>, Field<Header::Sequence, std::uint32_t>>>;
+
+using Pool = FramePool<PoolFrame, 4096>;
+
+static constexpr std::size_t burst{16};
+
+static Pool pool;
+
+static void
+allocate_malloc(benchmark::State& state)
+{
+   std::array<std::uint8_t*, burst> buffers;
+   for(auto _ : state) {
+      for(std::uint8_t*& buffer : buffers) {
+         buffer = static_cast<std::uint8_t*>(std::malloc(PoolFrame::required_size));
+         PoolFrame{buffer, PoolFrame::required_size}.inject<Header::Type>(std::uint8_t{1});
+      }
+      benchmark::ClobberMemory();
+      for(std::uint8_t* buffer : buffers) {
+         std::free(buffer);
+      }
+   }
+   state.SetItemsProcessed(state.iterations() * burst);
+}
+
+static void
+allocate_pool(benchmark::State& state)
+{
+   std::array<std::optional<PoolFrame>, burst> frames;
+   for(auto _ : state) {
+      for(std::optional<PoolFrame>& frame : frames) {
+         frame.emplace(*pool.acquire());
+         frame->inject<Header::Type>(std::uint8_t{1});
+      }
+      benchmark::ClobberMemory();
+      for(std::optional<PoolFrame>& frame : frames) {
+         pool.release(*frame);
+      }
+   }
+   state.SetItemsProcessed(state.iterations() * burst);
+}
+
+static void
+allocate_pool_cache(benchmark::State& state)
+{
+   Pool::Cache cache{pool};
+   std::array<std::optional<PoolFrame>, burst> frames;
+   for(auto _ : state) {
+      for(std::optional<PoolFrame>& frame : frames) {
+         frame.emplace(*cache.acquire());
+         frame->inject<Header::Type>(std::uint8_t{1});
+      }
+      benchmark::ClobberMemory();
+      for(std::optional<PoolFrame>& frame : frames) {
+         cache.release(*frame);
+      }
+   }
+   state.SetItemsProcessed(state.iterations() * burst);
+}
+
+BENCHMARK(allocate_malloc)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(allocate_pool)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(allocate_pool_cache)->ThreadRange(1, 8)->UseRealTime();
@@ -0,0 +1,103 @@
+//
+// Copyright (C) 2019 Tomasz Jankowski tomasz.jankowski.mail AT gmail.com>
+//
+// This is part of GBee library.
+//
+// GBee is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GBee is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#include <array>
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <gbee/gbee.hpp>
+
+enum class Header
+{
+   Control,
+   Sequence,
+   Pan,
+   Destination,
+   Source,
+   Radius,
+   Flags,
+   Version
+};
+
+using namespace gbee;
+
+using HeaderV1 = Frame<0,
+                       Group<LittleEndianField<Header::Control, std::uint16_t>,
+                             Field<Header::Sequence, std::uint8_t>,
+                             LittleEndianField<Header::Pan, std::uint16_t>,
+                             LittleEndianField<Header::Destination, std::uint64_t>,
+                             LittleEndianField<Header::Source, std::uint64_t>,
+                             Field<Header::Radius, std::uint8_t>,
+                             Field<Header::Flags, std::uint8_t>>>;
+
+using HeaderV2 = Frame<0,
+                       Group<Field<Header::Version, std::uint8_t>,
+                             LittleEndianField<Header::Control, std::uint16_t>,
+                             Field<Header::Sequence, std::uint8_t>,
+                             LittleEndianField<Header::Pan, std::uint16_t>,
+                             LittleEndianField<Header::Destination, std::uint64_t>,
+                             LittleEndianField<Header::Source, std::uint64_t>,
+                             Field<Header::Flags, std::uint8_t>,
+                             Field<Header::Radius, std::uint8_t>>>;
+
+template<auto id>
+static void
+move_field(const HeaderV1& source, HeaderV2& destination)
+{
+   HeaderV1::field_value_type<id> value;
+   source.extract<id>(value);
+   destination.inject<id>(value);
+}
+
+static void
+project_per_field(benchmark::State& state)
+{
+   std::array<std::uint8_t, HeaderV1::size> source_buffer{};
+   std::array<std::uint8_t, HeaderV2::size> destination_buffer{};
+   const HeaderV1 source{source_buffer};
+   HeaderV2 destination{destination_buffer};
+
+   for(auto _ : state) {
+      benchmark::ClobberMemory();
+      move_field<Header::Control>(source, destination);
+      move_field<Header::Sequence>(source, destination);
+      move_field<Header::Pan>(source, destination);
+      move_field<Header::Destination>(source, destination);
+      move_field<Header::Source>(source, destination);
+      move_field<Header::Radius>(source, destination);
+      move_field<Header::Flags>(source, destination);
+      benchmark::DoNotOptimize(destination_buffer.data());
+   }
+}
+
+static void
+project_coalesced(benchmark::State& state)
+{
+   std::array<std::uint8_t, HeaderV1::size> source_buffer{};
+   std::array<std::uint8_t, HeaderV2::size> destination_buffer{};
+   const HeaderV1 source{source_buffer};
+
+   for(auto _ : state) {
+      benchmark::ClobberMemory();
+      project(source, HeaderV2{destination_buffer});
+      benchmark::DoNotOptimize(destination_buffer.data());
+   }
+}
+
+BENCHMARK(project_per_field);
+BENCHMARK(project_coalesced);
@@ -0,0 +1,107 @@
+//
+// Copyright (C) 2019 Tomasz Jankowski tomasz.jankowski.mail AT gmail.com>
+//
+// This is part of GBee library.
+//
+// GBee is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GBee is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#include <array>
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <gbee/gbee.hpp>
+#include <vector>
+
+enum class Nwk
+{
+   Control,
+   Destination,
+   Source,
+   Radius,
+   Sequence
+};
+
+enum class Aux
+{
+   SecurityControl,
+   FrameCounter,
+   ExtendedSource,
+   KeySequence
+};
+
+using namespace gbee;
+
+using NwkFrame = Frame<0,
+                       Group<LittleEndianField<Nwk::Control, std::uint16_t>,
+                             LittleEndianField<Nwk::Destination, std::uint16_t>,
+                             LittleEndianField<Nwk::Source, std::uint16_t>,
+                             Field<Nwk::Radius, std::uint8_t>,
+                             Field<Nwk::Sequence, std::uint8_t>>,
+                       Group<Field<Aux::SecurityControl, std::uint8_t>,
+                             LittleEndianField<Aux::FrameCounter, std::uint32_t>,
+                             LittleEndianField<Aux::ExtendedSource, std::uint64_t>,
+                             Field<Aux::KeySequence, std::uint8_t>>>;
+
+using NwkSecurity = CcmStar<Nonce<Aux::ExtendedSource, Aux::FrameCounter, Aux::SecurityControl>>;
+
+static const Aes128 key{{{0x40, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49, 0x4a, 0x4b,
+                          0x4c, 0x4d, 0x4e, 0x4f}}};
+
+static constexpr std::size_t batch_size{16};
+
+static void
+seal_each(benchmark::State& state)
+{
+   const std::size_t length{static_cast<std::size_t>(state.range(0))};
+   const std::size_t frame_size{NwkFrame::size + length + NwkSecurity::mic_size};
+   std::vector<std::uint8_t> buffers(batch_size * frame_size);
+   std::vector<NwkFrame> frames;
+   for(std::size_t i = 0; i < batch_size; ++i) {
+      frames.emplace_back(buffers.data() + i * frame_size, frame_size);
+   }
+
+   for(auto _ : state) {
+      for(NwkFrame& frame : frames) {
+         seal<NwkSecurity>(key, frame, length);
+      }
+      benchmark::DoNotOptimize(buffers.data());
+      benchmark::ClobberMemory();
+   }
+   state.SetItemsProcessed(state.iterations() * batch_size);
+   state.SetBytesProcessed(state.iterations() * batch_size * length);
+}
+
+static void
+seal_batch(benchmark::State& state)
+{
+   const std::size_t length{static_cast<std::size_t>(state.range(0))};
+   const std::size_t frame_size{NwkFrame::size + length + NwkSecurity::mic_size};
+   std::vector<std::uint8_t> buffers(batch_size * frame_size);
+   std::vector<NwkFrame> frames;
+   for(std::size_t i = 0; i < batch_size; ++i) {
+      frames.emplace_back(buffers.data() + i * frame_size, frame_size);
+   }
+   const std::vector<std::size_t> lengths(batch_size, length);
+
+   for(auto _ : state) {
+      seal<NwkSecurity>(key, frames.data(), lengths.data(), frames.size());
+      benchmark::DoNotOptimize(buffers.data());
+      benchmark::ClobberMemory();
+   }
+   state.SetItemsProcessed(state.iterations() * batch_size);
+   state.SetBytesProcessed(state.iterations() * batch_size * length);
+}
+
+BENCHMARK(seal_each)->Arg(16)->Arg(64)->Arg(100);
+BENCHMARK(seal_batch)->Arg(16)->Arg(64)->Arg(100);
@@ -0,0 +1,112 @@
+//
+// Copyright (C) 2019 Tomasz Jankowski tomasz.jankowski.mail AT gmail.com>
+//
+// This is part of GBee library.
+//
+// GBee is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GBee is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#include <algorithm>
+#include <array>
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <cstring>
+#include <gbee/gbee.hpp>
+#include <vector>
+
+enum class Header
+{
+   Type,
+   Length
+};
+
+using namespace gbee;
+
+using HeaderGroup =
+  Group<Field<Header::Type, std::uint8_t>, LittleEndianField<Header::Length, std::uint16_t>>;
+
+using StreamFrame = FrameView<0, HeaderGroup>;
+
+static std::vector<std::uint8_t>
+make_stream(std::size_t size)
+{
+   std::vector<std::uint8_t> stream;
+   for(std::size_t i = 0; stream.size() < size; ++i) {
+      const std::size_t length{(i * 37) % 120};
+      stream.push_back(static_cast<std::uint8_t>(i));
+      stream.push_back(static_cast<std::uint8_t>(length));
+      stream.push_back(0);
+      stream.insert(stream.end(), length, static_cast<std::uint8_t>(i));
+   }
+   return stream;
+}
+
+struct Consumer
+{
+   void
+   operator()(const StreamFrame& frame)
+   {
+      std::uint8_t type;
+      frame.extract<Header::Type>(type);
+      checksum += type + frame.buffer_size;
+   }
+
+   std::size_t checksum{0};
+};
+
+static void
+stream_parser(benchmark::State& state)
+{
+   const std::size_t chunk{static_cast<std::size_t>(state.range(0))};
+   const std::vector<std::uint8_t> stream{make_stream(1 << 20)};
+   StreamParser<StreamFrame, Header::Length, 4096> parser;
+   Consumer consumer;
+
+   for(auto _ : state) {
+      for(std::size_t written = 0; written < stream.size();) {
+         written += parser.write(stream.data() + written, std::min(chunk, stream.size() - written));
+         parser.read(consumer);
+      }
+   }
+   benchmark::DoNotOptimize(consumer.checksum);
+   state.SetBytesProcessed(state.iterations() * stream.size());
+}
+
+// What StreamParser replaces: copying every frame out of the ring before building a view on it.
+static void
+copy_per_frame(benchmark::State& state)
+{
+   const std::size_t chunk{static_cast<std::size_t>(state.range(0))};
+   const std::vector<std::uint8_t> stream{make_stream(1 << 20)};
+   StreamParser<StreamFrame, Header::Length, 4096> parser;
+   std::array<std::uint8_t, 4096> linear;
+   Consumer consumer;
+   const auto copy{[&](const StreamFrame& frame) {
+      std::memcpy(linear.data(), frame.buffer, frame.buffer_size);
+      benchmark::ClobberMemory();
+      consumer(StreamFrame{linear.data(), frame.buffer_size});
+   }};
+
+   for(auto _ : state) {
+      for(std::size_t written = 0; written < stream.size();) {
+         written += parser.write(stream.data() + written, std::min(chunk, stream.size() - written));
+         parser.read(copy);
+      }
+   }
+   benchmark::DoNotOptimize(consumer.checksum);
+   state.SetBytesProcessed(state.iterations() * stream.size());
+}
+
+BENCHMARK(stream_parser)->Arg(1)->Arg(64)->Arg(1024);
+BENCHMARK(copy_per_frame)->Arg(1)->Arg(64)->Arg(1024);
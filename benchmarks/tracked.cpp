@@ -0,0 +1,94 @@
+//
+// Copyright (C) 2019 Tomasz Jankowski tomasz.jankowski.mail AT gmail.com>
+//
+// This is part of GBee library.
+//
+// GBee is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GBee is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#include <array>
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <gbee/gbee.hpp>
+
+enum class Mac
+{
+   Control,
+   Sequence,
+   Pan,
+   Destination,
+   Source,
+   Hops,
+   Body
+};
+
+enum class Trailer
+{
+   Fcs
+};
+
+using namespace gbee;
+
+using ForwardFrame = Frame<0,
+                           Group<LittleEndianField<Mac::Control, std::uint16_t>,
+                                 Field<Mac::Sequence, std::uint8_t>,
+                                 LittleEndianField<Mac::Pan, std::uint16_t>,
+                                 LittleEndianField<Mac::Destination, std::uint64_t>,
+                                 LittleEndianField<Mac::Source, std::uint64_t>,
+                                 Field<Mac::Hops, std::uint8_t>,
+                                 ArrayField<Mac::Body, std::uint8_t, 96>>,
+                           Group<Checksum<Trailer::Fcs, Crc16Kermit>>>;
+
+static void
+forward_rebuild(benchmark::State& state)
+{
+   std::array<std::uint8_t, ForwardFrame::size> buffer{};
+   ForwardFrame frame{buffer};
+   const std::array<std::uint8_t, 96> body{};
+   std::uint8_t sequence{0};
+
+   for(auto _ : state) {
+      frame.inject<Mac::Control>(std::uint16_t{0x8841});
+      frame.inject<Mac::Sequence>(sequence++);
+      frame.inject<Mac::Pan>(std::uint16_t{0xabcd});
+      frame.inject<Mac::Destination>(std::uint64_t{0x0102030405060708});
+      frame.inject<Mac::Source>(std::uint64_t{0x1112131415161718});
+      frame.inject<Mac::Hops>(static_cast<std::uint8_t>(sequence & 0x0f));
+      frame.inject<Mac::Body>(body);
+      frame.update_checksum<Trailer::Fcs>();
+      benchmark::DoNotOptimize(buffer.data());
+      benchmark::ClobberMemory();
+   }
+}
+
+static void
+forward_tracked(benchmark::State& state)
+{
+   std::array<std::uint8_t, ForwardFrame::size> buffer{};
+   ForwardFrame frame{buffer};
+   frame.update_checksum<Trailer::Fcs>();
+   TrackedFrame<ForwardFrame, Trailer::Fcs> tracked{frame};
+   std::uint8_t sequence{0};
+
+   for(auto _ : state) {
+      tracked.inject<Mac::Sequence>(sequence++);
+      tracked.inject<Mac::Hops>(static_cast<std::uint8_t>(sequence & 0x0f));
+      tracked.commit();
+      benchmark::DoNotOptimize(buffer.data());
+      benchmark::ClobberMemory();
+   }
+}
+
+BENCHMARK(forward_rebuild);
+BENCHMARK(forward_tracked);
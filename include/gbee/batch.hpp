@@ -0,0 +1,157 @@
+//
+// Copyright (C) 2019 Tomasz Jankowski tomasz.jankowski.mail AT gmail.com>
+//
+// This is part of GBee library.
+//
+// GBee is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GBee is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <gbee/byte_order.hpp>
+#include <gbee/group.hpp>
+#include <limits>
+#include <type_traits>
+
+#if defined(__AVX2__)
+#   include <immintrin.h>
+#endif
+
+namespace gbee {
+
+namespace details::batch {
+
+template<typename Field, auto id, typename T>
+inline constexpr bool is_gatherable{
+  std::is_base_of_v<gbee::Field<id, T, Field::byte_order>, Field> &&
+  (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8)};
+
+#if defined(__AVX2__)
+
+// Picks the first `size` bytes of every gathered 32-bit word (optionally byte swapped) and packs
+// them at the bottom of each 128-bit lane.
+template<std::size_t size, bool swap>
+constexpr std::array<std::uint8_t, 32>
+pack_shuffle()
+{
+   std::array<std::uint8_t, 32> shuffle{};
+   for(std::size_t lane = 0; lane < 2; ++lane) {
+      for(std::size_t i = 0; i < 16; ++i) {
+         const std::size_t word{i / size};
+         const std::size_t byte{swap ? size - 1 - i % size : i % size};
+         const bool used{size < 8 ? word < 4 : true};
+         shuffle[lane * 16 + i] = used ? static_cast<std::uint8_t>(
+                                           size < 8 ? word * 4 + byte : word * 8 + byte)
+                                       : 0x80;
+      }
+   }
+   return shuffle;
+}
+
+template<std::size_t size, bool swap>
+std::size_t
+gather(const std::uint8_t* source,
+       std::size_t readable,
+       std::size_t stride,
+       std::size_t count,
+       std::uint8_t* values)
+{
+   static constexpr std::array<std::uint8_t, 32> shuffle_table{pack_shuffle<size, swap>()};
+   const __m256i shuffle{
+     _mm256_loadu_si256(reinterpret_cast<const __m256i*>(shuffle_table.data()))};
+   const int step{static_cast<int>(stride)};
+
+   // Narrow fields are gathered as 32-bit words, keep the last word inside the buffer.
+   constexpr std::size_t read_size{size < 4 ? 4 : size};
+   constexpr std::size_t batch{size == 8 ? 4 : 8};
+
+   std::size_t i{0};
+   if constexpr(size == 8) {
+      const __m128i indexes{_mm_setr_epi32(0, step, 2 * step, 3 * step)};
+      for(; i + batch <= count && (i + batch - 1) * stride + read_size <= readable; i += batch) {
+         const auto* base{reinterpret_cast<const long long*>(source + i * stride)};
+         __m256i raw{_mm256_i32gather_epi64(base, indexes, 1)};
+         if constexpr(swap) {
+            raw = _mm256_shuffle_epi8(raw, shuffle);
+         }
+         _mm256_storeu_si256(reinterpret_cast<__m256i*>(values + i * size), raw);
+      }
+   }
+   else {
+      const __m256i indexes{
+        _mm256_setr_epi32(0, step, 2 * step, 3 * step, 4 * step, 5 * step, 6 * step, 7 * step)};
+      for(; i + batch <= count && (i + batch - 1) * stride + read_size <= readable; i += batch) {
+         const auto* base{reinterpret_cast<const int*>(source + i * stride)};
+         __m256i raw{_mm256_i32gather_epi32(base, indexes, 1)};
+         if constexpr(size == 4) {
+            if constexpr(swap) {
+               raw = _mm256_shuffle_epi8(raw, shuffle);
+            }
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(values + i * size), raw);
+         }
+         else if constexpr(size == 2) {
+            raw = _mm256_permute4x64_epi64(_mm256_shuffle_epi8(raw, shuffle), 0x08);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(values + i * size),
+                             _mm256_castsi256_si128(raw));
+         }
+         else {
+            raw = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(raw, shuffle),
+                                              _mm256_setr_epi32(0, 4, 0, 0, 0, 0, 0, 0));
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(values + i * size),
+                             _mm256_castsi256_si128(raw));
+         }
+      }
+   }
+   return i;
+}
+
+#endif
+
+} // namespace details::batch
+
+template<typename FrameType, auto id, typename T>
+void
+extract_column(const std::uint8_t* records,
+               std::size_t count,
+               T* values,
+               std::size_t stride = FrameType::size)
+{
+   static_assert(std::is_same_v<T, typename FrameType::template field_value_type<id>>);
+   using group_type = typename FrameType::template group_type<id>;
+   constexpr std::size_t field_offset{FrameType::template field_offset<id>};
+   constexpr std::size_t group_offset{field_offset - group_type::template offset<id>::value};
+
+   const std::size_t records_size{count * stride};
+
+   std::size_t i{0};
+#if defined(__AVX2__)
+   using field_type = typename FrameType::template field_type<id>;
+   if constexpr(details::batch::is_gatherable<field_type, id, T>) {
+      constexpr bool swap{details::byte_order::needs_swap<field_type::byte_order>};
+      if(stride <= std::numeric_limits<int>::max() / 8 && records_size >= field_offset) {
+         i = details::batch::gather<sizeof(T), swap>(records + field_offset,
+                                                     records_size - field_offset, stride, count,
+                                                     reinterpret_cast<std::uint8_t*>(values));
+      }
+   }
+#endif
+   for(; i < count; ++i) {
+      group_type::template extract<id>(records, records_size, values[i], i * stride + group_offset);
+   }
+}
+
+} // namespace gbee
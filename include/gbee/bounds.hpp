@@ -0,0 +1,177 @@
+//
+// Copyright (C) 2019 Tomasz Jankowski tomasz.jankowski.mail AT gmail.com>
+//
+// This is part of GBee library.
+//
+// GBee is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GBee is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+
+namespace gbee {
+
+struct Unchecked
+{
+   static constexpr void
+   check_buffer(std::size_t, std::size_t)
+   {}
+
+   static constexpr void
+   check_access(std::size_t, std::size_t)
+   {}
+
+   static constexpr void
+   check_length(std::size_t, std::size_t)
+   {}
+
+   static constexpr void
+   check_present(bool)
+   {}
+
+   static void
+   check_alignment(std::uintptr_t, std::size_t)
+   {}
+};
+
+struct CheckOnce
+{
+   static constexpr void
+   check_buffer(std::size_t buffer_size, std::size_t required_size)
+   {
+      if(buffer_size < required_size) {
+         throw std::out_of_range{"gbee: buffer is smaller than frame"};
+      }
+   }
+
+   static constexpr void
+   check_access(std::size_t, std::size_t)
+   {}
+
+   static constexpr void
+   check_length(std::size_t buffer_size, std::size_t length_end)
+   {
+      if(buffer_size < length_end) {
+         throw std::out_of_range{"gbee: length exceeds buffer"};
+      }
+   }
+
+   // Fields of an optional group absent from the current layout have no bytes in the buffer.
+   static constexpr void
+   check_present(bool present)
+   {
+      if(!present) {
+         throw std::out_of_range{"gbee: access to absent group"};
+      }
+   }
+
+   // Only called for policies promising an alignment, such as Aligned.
+   static void
+   check_alignment(std::uintptr_t address, std::size_t alignment)
+   {
+      if(address % alignment != 0) {
+         throw std::invalid_argument{"gbee: buffer is misaligned for the policy"};
+      }
+   }
+};
+
+struct CheckEachAccess
+{
+   static constexpr void
+   check_buffer(std::size_t, std::size_t)
+   {}
+
+   static constexpr void
+   check_access(std::size_t buffer_size, std::size_t access_end)
+   {
+      if(buffer_size < access_end) {
+         throw std::out_of_range{"gbee: access past end of buffer"};
+      }
+   }
+
+   static constexpr void
+   check_length(std::size_t buffer_size, std::size_t length_end)
+   {
+      CheckOnce::check_length(buffer_size, length_end);
+   }
+
+   static constexpr void
+   check_present(bool present)
+   {
+      CheckOnce::check_present(present);
+   }
+
+   static void
+   check_alignment(std::uintptr_t address, std::size_t alignment)
+   {
+      CheckOnce::check_alignment(address, alignment);
+   }
+};
+
+enum class Access
+{
+   inject,
+   extract
+};
+
+// Checks bounds like Bounds and hands every field inject() and extract() to Probe, which must
+// provide
+//
+//    template<typename Group, auto id, typename Accessor>
+//    static void access(Access access, Accessor&& accessor);
+//
+// and call accessor() exactly once. Other policies skip the hook at compile time.
+template<typename Probe, typename Bounds = Unchecked>
+struct Instrumented : public Bounds
+{
+   using probe_type = Probe;
+
+   using bounds_type = Bounds;
+};
+
+// Checks bounds like Bounds and promises frame buffers aligned to buffer_alignment bytes. Fields
+// at naturally aligned offsets are then accessed with aligned loads and stores, which matters on
+// targets where unaligned ones are split into byte accesses. A checking Bounds verifies the promise
+// when a frame is built.
+template<std::size_t buffer_alignment, typename Bounds = Unchecked>
+struct Aligned : public Bounds
+{
+   static_assert(buffer_alignment > 0 && (buffer_alignment & (buffer_alignment - 1)) == 0,
+                 "alignment has to be a power of two");
+
+   static constexpr std::size_t alignment{buffer_alignment};
+};
+
+namespace details {
+
+template<typename Policy, typename = void>
+inline constexpr std::size_t buffer_alignment{1};
+
+template<typename Policy>
+inline constexpr std::size_t
+  buffer_alignment<Policy, std::void_t<decltype(Policy::alignment)>>{Policy::alignment};
+
+template<typename Policy, typename = void>
+inline constexpr bool is_instrumented{false};
+
+template<typename Policy>
+inline constexpr bool is_instrumented<Policy, std::void_t<typename Policy::probe_type>>{true};
+
+} // namespace details
+
+} // namespace gbee
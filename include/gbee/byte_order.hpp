@@ -0,0 +1,283 @@
+//
+// Copyright (C) 2019 Tomasz Jankowski tomasz.jankowski.mail AT gmail.com>
+//
+// This is part of GBee library.
+//
+// GBee is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GBee is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <gbee/helpers.hpp>
+#include <type_traits>
+
+#if defined(__SSSE3__) || defined(__AVX2__)
+#   include <immintrin.h>
+#endif
+
+namespace gbee {
+
+enum class ByteOrder
+{
+   host,
+   little,
+   big
+};
+
+namespace details::byte_order {
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+inline constexpr ByteOrder native{ByteOrder::big};
+#else
+inline constexpr ByteOrder native{ByteOrder::little};
+#endif
+
+template<ByteOrder byte_order>
+inline constexpr bool needs_swap{byte_order != ByteOrder::host && byte_order != native};
+
+template<std::size_t size>
+struct word;
+
+template<>
+struct word<1>
+{
+   using type = std::uint8_t;
+};
+
+template<>
+struct word<2>
+{
+   using type = std::uint16_t;
+};
+
+template<>
+struct word<4>
+{
+   using type = std::uint32_t;
+};
+
+template<>
+struct word<8>
+{
+   using type = std::uint64_t;
+};
+
+template<typename T>
+inline constexpr bool is_swappable{(std::is_arithmetic_v<T> || std::is_enum_v<T>) &&
+                                   (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 ||
+                                    sizeof(T) == 8)};
+
+constexpr std::uint8_t
+swap(std::uint8_t value)
+{
+   return value;
+}
+
+constexpr std::uint16_t
+swap(std::uint16_t value)
+{
+   return __builtin_bswap16(value);
+}
+
+constexpr std::uint32_t
+swap(std::uint32_t value)
+{
+   return __builtin_bswap32(value);
+}
+
+constexpr std::uint64_t
+swap(std::uint64_t value)
+{
+   return __builtin_bswap64(value);
+}
+
+template<ByteOrder byte_order>
+inline constexpr bool is_big{byte_order == ByteOrder::big ||
+                             (byte_order == ByteOrder::host && native == ByteOrder::big)};
+
+template<ByteOrder byte_order, typename T>
+constexpr void
+store(std::uint8_t* destination, const T& value)
+{
+   if constexpr(is_swappable<T>) {
+      if(is_constant_evaluated()) {
+         const auto raw{__builtin_bit_cast(typename word<sizeof(T)>::type, value)};
+         for(std::size_t i = 0; i < sizeof(T); ++i) {
+            destination[is_big<byte_order> ? sizeof(T) - 1 - i : i] =
+              static_cast<std::uint8_t>(raw >> (i * 8));
+         }
+         return;
+      }
+   }
+
+   if constexpr(needs_swap<byte_order>) {
+      static_assert(is_swappable<T>, "byte order conversion requires a scalar type");
+      typename word<sizeof(T)>::type raw{};
+      std::memcpy(&raw, &value, sizeof(T));
+      raw = swap(raw);
+      std::memcpy(destination, &raw, sizeof(T));
+   }
+   else {
+      std::memcpy(destination, &value, sizeof(T));
+   }
+}
+
+template<ByteOrder byte_order, typename T>
+constexpr void
+load(const std::uint8_t* source, T& value)
+{
+   if constexpr(is_swappable<T>) {
+      if(is_constant_evaluated()) {
+         using word_type = typename word<sizeof(T)>::type;
+         word_type raw{0};
+         for(std::size_t i = 0; i < sizeof(T); ++i) {
+            const word_type byte{source[is_big<byte_order> ? sizeof(T) - 1 - i : i]};
+            raw = static_cast<word_type>(raw | static_cast<word_type>(byte << (i * 8)));
+         }
+         value = __builtin_bit_cast(T, raw);
+         return;
+      }
+   }
+
+   if constexpr(needs_swap<byte_order>) {
+      static_assert(is_swappable<T>, "byte order conversion requires a scalar type");
+      typename word<sizeof(T)>::type raw{};
+      std::memcpy(&raw, source, sizeof(T));
+      raw = swap(raw);
+      std::memcpy(&value, &raw, sizeof(T));
+   }
+   else {
+      std::memcpy(&value, source, sizeof(T));
+   }
+}
+
+// Little endian word held in its first size bytes only, as for a run of bit fields whose width is
+// not a word size; the other bytes are neither read nor written.
+template<std::size_t size, typename Word>
+constexpr void
+load_partial(const std::uint8_t* source, Word& word)
+{
+   if constexpr(size == sizeof(Word)) {
+      load<ByteOrder::little>(source, word);
+   }
+   else {
+      word = 0;
+      for(std::size_t i = 0; i < size; ++i) {
+         word = static_cast<Word>(word | static_cast<Word>(Word{source[i]} << (i * 8)));
+      }
+   }
+}
+
+template<std::size_t size, typename Word>
+constexpr void
+store_partial(std::uint8_t* destination, Word word)
+{
+   if constexpr(size == sizeof(Word)) {
+      store<ByteOrder::little>(destination, word);
+   }
+   else {
+      for(std::size_t i = 0; i < size; ++i) {
+         destination[i] = static_cast<std::uint8_t>(word >> (i * 8));
+      }
+   }
+}
+
+template<std::size_t size>
+constexpr std::array<std::uint8_t, 32>
+swap_shuffle()
+{
+   std::array<std::uint8_t, 32> shuffle{};
+   for(std::size_t i = 0; i < shuffle.size(); ++i) {
+      const std::size_t lane_index{i % 16};
+      shuffle[i] = static_cast<std::uint8_t>(lane_index - lane_index % size + size - 1 -
+                                             lane_index % size);
+   }
+   return shuffle;
+}
+
+template<std::size_t size>
+void
+swap_n(std::uint8_t* destination, const std::uint8_t* source, std::size_t count)
+{
+   std::size_t i{0};
+#if defined(__SSSE3__) || defined(__AVX2__)
+   static constexpr std::array<std::uint8_t, 32> shuffle{swap_shuffle<size>()};
+#endif
+#if defined(__AVX2__)
+   const __m256i shuffle_256{_mm256_loadu_si256(reinterpret_cast<const __m256i*>(shuffle.data()))};
+   for(; i + 32 / size <= count; i += 32 / size) {
+      const __m256i raw{_mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + i * size))};
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(destination + i * size),
+                          _mm256_shuffle_epi8(raw, shuffle_256));
+   }
+#endif
+#if defined(__SSSE3__)
+   const __m128i shuffle_128{_mm_loadu_si128(reinterpret_cast<const __m128i*>(shuffle.data()))};
+   for(; i + 16 / size <= count; i += 16 / size) {
+      const __m128i raw{_mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i * size))};
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i * size),
+                       _mm_shuffle_epi8(raw, shuffle_128));
+   }
+#endif
+   for(; i < count; ++i) {
+      typename word<size>::type raw;
+      std::memcpy(&raw, source + i * size, size);
+      raw = swap(raw);
+      std::memcpy(destination + i * size, &raw, size);
+   }
+}
+
+template<ByteOrder byte_order, typename T>
+constexpr void
+store_n(std::uint8_t* destination, const T* values, std::size_t count)
+{
+   if(is_constant_evaluated()) {
+      for(std::size_t i = 0; i < count; ++i) {
+         store<byte_order>(destination + i * sizeof(T), values[i]);
+      }
+   }
+   else if constexpr(needs_swap<byte_order> && sizeof(T) > 1) {
+      static_assert(is_swappable<T>, "byte order conversion requires a scalar type");
+      swap_n<sizeof(T)>(destination, reinterpret_cast<const std::uint8_t*>(values), count);
+   }
+   else {
+      std::memcpy(destination, values, count * sizeof(T));
+   }
+}
+
+template<ByteOrder byte_order, typename T>
+constexpr void
+load_n(const std::uint8_t* source, T* values, std::size_t count)
+{
+   if(is_constant_evaluated()) {
+      for(std::size_t i = 0; i < count; ++i) {
+         load<byte_order>(source + i * sizeof(T), values[i]);
+      }
+   }
+   else if constexpr(needs_swap<byte_order> && sizeof(T) > 1) {
+      static_assert(is_swappable<T>, "byte order conversion requires a scalar type");
+      swap_n<sizeof(T)>(reinterpret_cast<std::uint8_t*>(values), source, count);
+   }
+   else {
+      std::memcpy(values, source, count * sizeof(T));
+   }
+}
+
+} // namespace details::byte_order
+
+} // namespace gbee
@@ -0,0 +1,969 @@
+//
+// Copyright (C) 2019 Tomasz Jankowski tomasz.jankowski.mail AT gmail.com>
+//
+// This is part of GBee library.
+//
+// GBee is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GBee is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <gbee/frame.hpp>
+#include <gbee/group.hpp>
+#include <gbee/helpers.hpp>
+#include <gbee/span.hpp>
+#include <stdexcept>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <system_error>
+#include <type_traits>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+namespace gbee {
+
+// Fields whose smallest and largest value are kept for every block of a capture segment, so
+// that queries on them skip whole blocks without reading their frames.
+template<auto... ids>
+struct IndexFields
+{};
+
+// Slowly changing fields, such as a timestamp, stored as the zigzag varint difference to the
+// same field of the previous frame in the block instead of at full width.
+template<auto... ids>
+struct DeltaFields
+{};
+
+// Inclusive bounds on one field, as matched by Capture::Reader::select().
+template<auto initial_id, typename T>
+struct Range
+{
+   static constexpr auto id{initial_id};
+   T low;
+   T high;
+};
+
+template<auto id, typename T>
+constexpr Range<id, T>
+between(T low, T high)
+{
+   return {low, high};
+}
+
+template<auto id, typename T>
+constexpr Range<id, T>
+equal_to(T value)
+{
+   return {value, value};
+}
+
+namespace details::capture {
+
+enum class Header
+{
+   Magic,
+   Version,
+   IndexCount,
+   DeltaCount,
+   FrameSize,
+   BlockFrames
+};
+
+enum class Entry
+{
+   Offset,
+   Size,
+   Count,
+   Bounds
+};
+
+enum class Trailer
+{
+   IndexOffset,
+   BlockCount,
+   Magic
+};
+
+inline constexpr std::array<std::uint8_t, 8> header_magic{{'g', 'b', 'e', 'e', 'c', 'a', 'p', 0}};
+
+inline constexpr std::array<std::uint8_t, 8> trailer_magic{{'g', 'b', 'e', 'e', 'i', 'd', 'x', 0}};
+
+inline constexpr std::uint16_t version{1};
+
+using HeaderGroup = Group<ArrayField<Header::Magic, std::uint8_t, 8>,
+                          LittleEndianField<Header::Version, std::uint16_t>,
+                          Field<Header::IndexCount, std::uint8_t>,
+                          Field<Header::DeltaCount, std::uint8_t>,
+                          LittleEndianField<Header::FrameSize, std::uint32_t>,
+                          LittleEndianField<Header::BlockFrames, std::uint32_t>>;
+
+using TrailerGroup = Group<LittleEndianField<Trailer::IndexOffset, std::uint64_t>,
+                           LittleEndianField<Trailer::BlockCount, std::uint32_t>,
+                           ArrayField<Trailer::Magic, std::uint8_t, 8>>;
+
+// One index entry per block: where its records start, their total size and count, followed by
+// the smallest and largest value of every index field.
+template<std::size_t bound_count>
+struct entry_group
+{
+   using type = Group<LittleEndianField<Entry::Offset, std::uint64_t>,
+                      LittleEndianField<Entry::Size, std::uint32_t>,
+                      LittleEndianField<Entry::Count, std::uint32_t>,
+                      ArrayField<Entry::Bounds, std::uint64_t, bound_count, ByteOrder::little>>;
+};
+
+template<>
+struct entry_group<0>
+{
+   using type = Group<LittleEndianField<Entry::Offset, std::uint64_t>,
+                      LittleEndianField<Entry::Size, std::uint32_t>,
+                      LittleEndianField<Entry::Count, std::uint32_t>>;
+};
+
+inline constexpr std::size_t max_varint_size{10};
+
+inline std::size_t
+write_varint(std::uint8_t* destination, std::uint64_t value)
+{
+   std::size_t size{0};
+   while(value >= 0x80) {
+      destination[size++] = static_cast<std::uint8_t>(value | 0x80);
+      value >>= 7;
+   }
+   destination[size++] = static_cast<std::uint8_t>(value);
+   return size;
+}
+
+// Returns the number of bytes read, or 0 if the varint is cut off by end or overlong.
+inline std::size_t
+read_varint(const std::uint8_t* source, const std::uint8_t* end, std::uint64_t& value)
+{
+   value = 0;
+   for(std::size_t size = 0; size < max_varint_size && source + size < end; ++size) {
+      value |= std::uint64_t{source[size] & 0x7fu} << (size * 7);
+      if(!(source[size] & 0x80)) {
+         return size + 1;
+      }
+   }
+   return 0;
+}
+
+inline constexpr std::uint64_t sign_bit{std::uint64_t{1} << 63};
+
+// Maps integers and enums onto std::uint64_t keeping their order, so that bounds of every
+// field type are stored and compared the same way.
+template<typename T>
+constexpr std::uint64_t
+to_ordered(T value)
+{
+   if constexpr(std::is_enum_v<T>) {
+      return to_ordered(static_cast<std::underlying_type_t<T>>(value));
+   }
+   else if constexpr(std::is_signed_v<T>) {
+      return static_cast<std::uint64_t>(static_cast<std::int64_t>(value)) ^ sign_bit;
+   }
+   else {
+      return static_cast<std::uint64_t>(value);
+   }
+}
+
+template<typename T>
+constexpr T
+from_ordered(std::uint64_t value)
+{
+   if constexpr(std::is_enum_v<T>) {
+      return static_cast<T>(from_ordered<std::underlying_type_t<T>>(value));
+   }
+   else if constexpr(std::is_signed_v<T>) {
+      return static_cast<T>(static_cast<std::int64_t>(value ^ sign_bit));
+   }
+   else {
+      return static_cast<T>(value);
+   }
+}
+
+template<typename FrameType, auto id>
+inline constexpr bool is_integer_field{
+  std::is_integral_v<typename FrameType::template field_value_type<id>> ||
+  std::is_enum_v<typename FrameType::template field_value_type<id>>};
+
+template<typename FrameType, auto id, typename Frame>
+std::uint64_t
+ordered_value(const Frame& frame)
+{
+   typename FrameType::template field_value_type<id> value;
+   frame.template extract<id>(value);
+   return to_ordered(value);
+}
+
+template<typename FrameType, typename Index>
+struct index;
+
+template<typename FrameType, auto... ids>
+struct index<FrameType, IndexFields<ids...>>
+{
+   static_assert(are_values_unique<ids...>);
+   static_assert((is_integer_field<FrameType, ids> && ...), "index fields have to be integers");
+
+   static constexpr std::size_t count{sizeof...(ids)};
+
+   // Smallest and largest value of each field, in field order.
+   using Bounds = std::array<std::uint64_t, 2 * count>;
+
+   static Bounds
+   empty()
+   {
+      Bounds bounds;
+      for(std::size_t i = 0; i < count; ++i) {
+         bounds[2 * i] = ~std::uint64_t{0};
+         bounds[2 * i + 1] = 0;
+      }
+      return bounds;
+   }
+
+   template<typename Frame>
+   static void
+   add(Bounds& bounds, const Frame& frame)
+   {
+      std::size_t i{0};
+      (widen(bounds, i++, ordered_value<FrameType, ids>(frame)), ...);
+   }
+
+   // Whether a block with these bounds may hold a frame within range. Ranges on fields that are
+   // not indexed never rule a block out.
+   template<auto id, typename T>
+   static bool
+   may_match(const Bounds& bounds, const Range<id, T>& range)
+   {
+      constexpr std::size_t position{details::value_index<id, ids...>()};
+      if constexpr(position == count) {
+         return true;
+      }
+      else {
+         using Value = typename FrameType::template field_value_type<id>;
+         return to_ordered(static_cast<Value>(range.low)) <= bounds[2 * position + 1] &&
+                to_ordered(static_cast<Value>(range.high)) >= bounds[2 * position];
+      }
+   }
+
+ private:
+   static void
+   widen(Bounds& bounds, std::size_t i, std::uint64_t value)
+   {
+      bounds[2 * i] = std::min(bounds[2 * i], value);
+      bounds[2 * i + 1] = std::max(bounds[2 * i + 1], value);
+   }
+};
+
+template<typename FrameType, typename Delta>
+struct delta;
+
+template<typename FrameType, auto... ids>
+struct delta<FrameType, DeltaFields<ids...>>
+{
+   static_assert(are_values_unique<ids...>);
+   static_assert((is_integer_field<FrameType, ids> && ...), "delta fields have to be integers");
+   static_assert(((FrameType::template field_bit_offset<ids> % 8 == 0 &&
+                   !FrameType::template field_type<ids>::is_bit_field) &&
+                  ...),
+                 "delta fields have to be byte aligned");
+
+   static constexpr std::size_t count{sizeof...(ids)};
+
+   static constexpr std::size_t removed_size{(0 + ... + FrameType::template field_type<ids>::size)};
+
+   using Values = std::array<std::uint64_t, count>;
+
+   struct Run
+   {
+      std::size_t offset;
+      std::size_t size;
+   };
+
+   // Byte runs of the groups left once the delta fields are taken out, in frame order. The
+   // payload is stored right after the last one.
+   static constexpr auto split{[] {
+      std::array<Run, count> removed{
+        {Run{FrameType::template field_offset<ids>, FrameType::template field_type<ids>::size}...}};
+      for(std::size_t i = 1; i < count; ++i) {
+         for(std::size_t j = i; j > 0 && removed[j - 1].offset > removed[j].offset; --j) {
+            const Run moved{removed[j]};
+            removed[j] = removed[j - 1];
+            removed[j - 1] = moved;
+         }
+      }
+      std::array<Run, count + 1> kept{};
+      std::size_t kept_count{0};
+      std::size_t position{0};
+      for(const Run& run : removed) {
+         if(run.offset > position) {
+            kept[kept_count++] = Run{position, run.offset - position};
+         }
+         position = run.offset + run.size;
+      }
+      kept[kept_count++] = Run{position, FrameType::size - position};
+      return std::make_pair(kept, kept_count);
+   }()};
+
+   static constexpr std::size_t run_count{split.second};
+
+   static constexpr std::array<Run, count + 1> runs{split.first};
+
+   // Writes the varint deltas of frame against previous, which is updated, and returns their
+   // size.
+   static std::size_t
+   encode([[maybe_unused]] const std::uint8_t* frame,
+          [[maybe_unused]] Values& previous,
+          [[maybe_unused]] std::uint8_t* destination)
+   {
+      std::size_t size{0};
+      std::size_t i{0};
+      ((size += encode_field<ids>(frame, previous[i++], destination + size)), ...);
+      return size;
+   }
+
+   // Copies frame without the delta fields.
+   static void
+   strip(const std::uint8_t* frame, std::size_t frame_size, std::uint8_t* destination)
+   {
+      for(std::size_t i = 0; i + 1 < run_count; ++i) {
+         std::memcpy(destination, frame + runs[i].offset, runs[i].size);
+         destination += runs[i].size;
+      }
+      const Run& last{runs[run_count - 1]};
+      std::memcpy(destination, frame + last.offset, frame_size - last.offset);
+   }
+
+   // Rebuilds the frame stored in [record, end) into frame, growing it when needed, and returns
+   // its size, or 0 if the record is malformed.
+   static std::size_t
+   restore(const std::uint8_t* record,
+           const std::uint8_t* end,
+           Values& previous,
+           std::vector<std::uint8_t>& frame)
+   {
+      std::array<std::uint64_t, count> deltas;
+      for(std::uint64_t& value : deltas) {
+         const std::size_t size{read_varint(record, end, value)};
+         if(size == 0) {
+            return 0;
+         }
+         record += size;
+      }
+      const std::size_t stored_size{static_cast<std::size_t>(end - record)};
+      if(stored_size + removed_size < FrameType::size) {
+         return 0;
+      }
+
+      const std::size_t frame_size{stored_size + removed_size};
+      if(frame.size() < frame_size) {
+         frame.resize(frame_size);
+      }
+      for(std::size_t i = 0; i + 1 < run_count; ++i) {
+         std::memcpy(frame.data() + runs[i].offset, record, runs[i].size);
+         record += runs[i].size;
+      }
+      const Run& last{runs[run_count - 1]};
+      std::memcpy(frame.data() + last.offset, record, frame_size - last.offset);
+
+      std::size_t i{0};
+      ((restore_field<ids>(deltas[i], previous[i], frame.data()), ++i), ...);
+      return frame_size;
+   }
+
+ private:
+   template<auto id>
+   static std::size_t
+   encode_field(const std::uint8_t* frame, std::uint64_t& previous, std::uint8_t* destination)
+   {
+      using field = typename FrameType::template field_type<id>;
+      typename field::value_type value;
+      field::load(frame + FrameType::template field_offset<id>, value);
+      const std::uint64_t current{to_ordered(value)};
+      const std::int64_t difference{static_cast<std::int64_t>(current - previous)};
+      previous = current;
+      return write_varint(destination, static_cast<std::uint64_t>(difference) << 1 ^
+                                         static_cast<std::uint64_t>(difference >> 63));
+   }
+
+   template<auto id>
+   static void
+   restore_field(std::uint64_t zigzag, std::uint64_t& previous, std::uint8_t* frame)
+   {
+      using field = typename FrameType::template field_type<id>;
+      previous += zigzag >> 1 ^ (~(zigzag & 1) + 1);
+      field::store(frame + FrameType::template field_offset<id>,
+                   from_ordered<typename field::value_type>(previous));
+   }
+};
+
+} // namespace details::capture
+
+// Append-only recording of frames laid out as FrameType, split into segment files of about
+// segment_size bytes. Each segment holds blocks of block_frames records and ends with a sparse
+// index of the blocks, giving the bounds of every Index field. Segments are read back through
+// mmap(): frames are handed out in place unless Delta fields have to be restored.
+template<typename FrameType, typename Index = IndexFields<>, typename Delta = DeltaFields<>>
+class Capture
+{
+   static_assert(std::is_constructible_v<FrameType, const std::uint8_t*, std::size_t>,
+                 "frame type cannot be built over a read-only buffer");
+
+   using index = details::capture::index<FrameType, Index>;
+   using delta = details::capture::delta<FrameType, Delta>;
+   using header_frame = Frame<0, details::capture::HeaderGroup>;
+   using header_view = FrameView<0, details::capture::HeaderGroup>;
+   using trailer_frame = Frame<0, details::capture::TrailerGroup>;
+   using trailer_view = FrameView<0, details::capture::TrailerGroup>;
+   using entry_group = typename details::capture::entry_group<2 * index::count>::type;
+
+ public:
+   class Writer;
+   class Reader;
+
+   // Segment files of directory, oldest first.
+   static std::vector<std::filesystem::path>
+   segments(const std::filesystem::path& directory)
+   {
+      std::vector<std::pair<std::uint64_t, std::filesystem::path>> numbered;
+      for(const std::filesystem::directory_entry& entry :
+          std::filesystem::directory_iterator{directory}) {
+         std::uint64_t number;
+         if(parse_name(entry.path(), number)) {
+            numbered.emplace_back(number, entry.path());
+         }
+      }
+      std::sort(numbered.begin(), numbered.end());
+      std::vector<std::filesystem::path> paths;
+      for(auto& segment : numbered) {
+         paths.push_back(std::move(segment.second));
+      }
+      return paths;
+   }
+
+ private:
+   static constexpr char extension[]{".capture"};
+
+   static std::filesystem::path
+   segment_name(std::uint64_t number)
+   {
+      std::string name{std::to_string(number)};
+      if(name.size() < 8) {
+         name.insert(0, 8 - name.size(), '0');
+      }
+      return name + extension;
+   }
+
+   static bool
+   parse_name(const std::filesystem::path& path, std::uint64_t& number)
+   {
+      const std::string stem{path.stem().string()};
+      if(path.extension() != extension || stem.empty() ||
+         !std::all_of(stem.begin(), stem.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+         return false;
+      }
+      number = std::stoull(stem);
+      return true;
+   }
+};
+
+template<typename FrameType, typename Index, typename Delta>
+class Capture<FrameType, Index, Delta>::Writer
+{
+ public:
+   // Records are staged in memory and handed to the operating system in chunks of this size.
+   static constexpr std::size_t buffer_size{std::size_t{1} << 18};
+
+   explicit Writer(std::filesystem::path initial_directory,
+                   std::size_t initial_block_frames = 256,
+                   std::size_t initial_segment_size = std::size_t{64} << 20)
+     : directory{std::move(initial_directory)},
+       block_frames{initial_block_frames},
+       segment_size{initial_segment_size}
+   {
+      if(block_frames == 0 || block_frames > 0xffffffff) {
+         throw std::invalid_argument{"gbee: capture block size out of range"};
+      }
+      std::filesystem::create_directories(directory);
+      const std::vector<std::filesystem::path> existing{segments(directory)};
+      if(!existing.empty()) {
+         parse_name(existing.back(), next_segment);
+         ++next_segment;
+      }
+   }
+
+   Writer(const Writer&) = delete;
+
+   Writer&
+   operator=(const Writer&) = delete;
+
+   ~Writer()
+   {
+      try {
+         close();
+      }
+      catch(...) {
+      }
+   }
+
+   // Records the groups of frame and the payload_length bytes following them.
+   template<typename Frame>
+   void
+   append(const Frame& frame, std::size_t payload_length)
+   {
+      const std::size_t frame_size{FrameType::size + payload_length};
+      Frame::policy_type::check_length(frame.buffer_size, frame_size);
+      if(file == -1) {
+         open_segment();
+      }
+
+      std::array<std::uint8_t, details::capture::max_varint_size * delta::count> deltas;
+      const std::size_t delta_size{delta::encode(frame.buffer, previous, deltas.data())};
+      const std::size_t length{delta_size + frame_size - delta::removed_size};
+
+      const std::size_t record_size{details::capture::max_varint_size + length};
+      if(staged_size + record_size > staged.size()) {
+         flush();
+         if(record_size > staged.size()) {
+            staged.resize(record_size);
+         }
+      }
+      std::uint8_t* const record{staged.data() + staged_size};
+      std::uint8_t* position{record + details::capture::write_varint(record, length)};
+      if constexpr(delta::count > 0) {
+         std::memcpy(position, deltas.data(), delta_size);
+      }
+      delta::strip(frame.buffer, frame_size, position + delta_size);
+      position += length;
+
+      staged_size += static_cast<std::size_t>(position - record);
+      written += static_cast<std::size_t>(position - record);
+      index::add(bounds, frame);
+      ++block_count;
+
+      if(block_count == block_frames || written - block_offset > max_block_size) {
+         finish_block();
+         if(written >= segment_size) {
+            close();
+         }
+      }
+   }
+
+   // Hands staged records to the operating system. A segment cut short after a flush() is still
+   // readable: its index is rebuilt from the records.
+   void
+   flush()
+   {
+      write_all(staged.data(), staged_size);
+      staged_size = 0;
+   }
+
+   // Writes the index of the current segment and closes it; the next append() starts a new one.
+   void
+   close()
+   {
+      if(file == -1) {
+         return;
+      }
+      finish_block();
+      flush();
+      write_all(entries.data(), entries.size());
+
+      std::array<std::uint8_t, trailer_frame::size> trailer;
+      trailer_frame fields{trailer.data(), trailer.size()};
+      fields.template inject<details::capture::Trailer::IndexOffset>(
+        std::uint64_t{written});
+      fields.template inject<details::capture::Trailer::BlockCount>(
+        static_cast<std::uint32_t>(entries.size() / entry_group::size));
+      fields.template inject<details::capture::Trailer::Magic>(
+        details::capture::trailer_magic);
+      write_all(trailer.data(), trailer.size());
+
+      ::close(file);
+      file = -1;
+      entries.clear();
+   }
+
+ private:
+   static constexpr std::size_t max_block_size{0x7fffffff};
+
+   void
+   open_segment()
+   {
+      const std::filesystem::path path{directory / segment_name(next_segment)};
+      file = ::open(path.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+      if(file == -1) {
+         throw std::system_error{errno, std::generic_category(),
+                                 "gbee: cannot create capture segment"};
+      }
+      ++next_segment;
+
+      header_frame header{staged.data(), header_frame::size};
+      header.template inject<details::capture::Header::Magic>(details::capture::header_magic);
+      header.template inject<details::capture::Header::Version>(details::capture::version);
+      header.template inject<details::capture::Header::IndexCount>(
+        static_cast<std::uint8_t>(index::count));
+      header.template inject<details::capture::Header::DeltaCount>(
+        static_cast<std::uint8_t>(delta::count));
+      header.template inject<details::capture::Header::FrameSize>(
+        static_cast<std::uint32_t>(FrameType::size));
+      header.template inject<details::capture::Header::BlockFrames>(
+        static_cast<std::uint32_t>(block_frames));
+      staged_size = header_frame::size;
+      written = header_frame::size;
+      block_offset = written;
+   }
+
+   void
+   finish_block()
+   {
+      if(block_count == 0) {
+         return;
+      }
+      entries.resize(entries.size() + entry_group::size);
+      Frame<0, entry_group> entry{entries.data() + entries.size() - entry_group::size,
+                                  entry_group::size};
+      entry.template inject<details::capture::Entry::Offset>(std::uint64_t{block_offset});
+      entry.template inject<details::capture::Entry::Size>(
+        static_cast<std::uint32_t>(written - block_offset));
+      entry.template inject<details::capture::Entry::Count>(
+        static_cast<std::uint32_t>(block_count));
+      if constexpr(index::count > 0) {
+         entry.template inject<details::capture::Entry::Bounds>(bounds);
+      }
+
+      block_offset = written;
+      block_count = 0;
+      bounds = index::empty();
+      previous = {};
+   }
+
+   void
+   write_all(const std::uint8_t* data, std::size_t size)
+   {
+      while(size > 0) {
+         const ssize_t result{::write(file, data, size)};
+         if(result == -1) {
+            if(errno == EINTR) {
+               continue;
+            }
+            throw std::system_error{errno, std::generic_category(),
+                                    "gbee: cannot write capture segment"};
+         }
+         data += result;
+         size -= static_cast<std::size_t>(result);
+      }
+   }
+
+   const std::filesystem::path directory;
+   const std::size_t block_frames;
+   const std::size_t segment_size;
+   std::uint64_t next_segment{0};
+   int file{-1};
+
+   std::vector<std::uint8_t> staged = std::vector<std::uint8_t>(buffer_size);
+   std::size_t staged_size{0};
+   std::uint64_t written{0};
+
+   std::uint64_t block_offset{0};
+   std::size_t block_count{0};
+   typename index::Bounds bounds{index::empty()};
+   typename delta::Values previous{};
+   std::vector<std::uint8_t> entries;
+};
+
+template<typename FrameType, typename Index, typename Delta>
+class Capture<FrameType, Index, Delta>::Reader
+{
+ public:
+   explicit Reader(const std::filesystem::path& path)
+   {
+      const int file{::open(path.c_str(), O_RDONLY | O_CLOEXEC)};
+      if(file == -1) {
+         throw std::system_error{errno, std::generic_category(),
+                                 "gbee: cannot open capture segment"};
+      }
+      struct stat status;
+      if(::fstat(file, &status) == -1) {
+         const int error{errno};
+         ::close(file);
+         throw std::system_error{error, std::generic_category(),
+                                 "gbee: cannot open capture segment"};
+      }
+      size = static_cast<std::size_t>(status.st_size);
+      if(size < header_frame::size) {
+         ::close(file);
+         throw std::runtime_error{"gbee: not a capture segment"};
+      }
+      void* const mapping{::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0)};
+      const int error{errno};
+      ::close(file);
+      if(mapping == MAP_FAILED) {
+         throw std::system_error{error, std::generic_category(),
+                                 "gbee: cannot map capture segment"};
+      }
+      data = static_cast<const std::uint8_t*>(mapping);
+
+      try {
+         load_index();
+      }
+      catch(...) {
+         ::munmap(const_cast<std::uint8_t*>(data), size);
+         throw;
+      }
+   }
+
+   Reader(const Reader&) = delete;
+
+   Reader&
+   operator=(const Reader&) = delete;
+
+   ~Reader()
+   {
+      ::munmap(const_cast<std::uint8_t*>(data), size);
+   }
+
+   // The mapped segment file.
+   Span<const std::uint8_t>
+   bytes() const
+   {
+      return {data, size};
+   }
+
+   std::size_t
+   block_count() const
+   {
+      return blocks.size();
+   }
+
+   std::size_t
+   frame_count() const
+   {
+      std::size_t count{0};
+      for(const Block& block : blocks) {
+         count += block.count;
+      }
+      return count;
+   }
+
+   // Whether the segment was not closed by its writer and its index had to be rebuilt.
+   bool
+   recovered() const
+   {
+      return rebuilt;
+   }
+
+   template<typename Handler>
+   std::size_t
+   for_each(Handler&& handler) const
+   {
+      return select(handler);
+   }
+
+   // Calls handler(FrameType) for every frame within all ranges and returns their count. Blocks
+   // whose index bounds rule out a range are skipped. Frames point into the mapping, or into a
+   // buffer reused for the next frame when Delta fields are present.
+   template<typename Handler, auto... ids, typename... Ts>
+   std::size_t
+   select(Handler&& handler, const Range<ids, Ts>&... ranges) const
+   {
+      std::vector<std::uint8_t> scratch;
+      std::size_t matched{0};
+      for(const Block& block : blocks) {
+         if(!(index::may_match(block.bounds, ranges) && ...)) {
+            continue;
+         }
+         const std::uint8_t* const begin{data + block.offset};
+         const std::uint8_t* const end{begin + block.size};
+         std::size_t count{0};
+         const std::uint8_t* const last{
+           walk(begin, end, block.count, scratch, [&](const FrameType& frame) {
+              ++count;
+              if((contains(frame, ranges) && ...)) {
+                 handler(frame);
+                 ++matched;
+              }
+           })};
+         if(last != end || count != block.count) {
+            throw std::runtime_error{"gbee: corrupt capture segment"};
+         }
+      }
+      return matched;
+   }
+
+ private:
+   struct Block
+   {
+      std::uint64_t offset;
+      std::uint32_t size;
+      std::uint32_t count;
+      typename index::Bounds bounds;
+   };
+
+   template<auto id, typename T>
+   static bool
+   contains(const FrameType& frame, const Range<id, T>& range)
+   {
+      using Value = typename FrameType::template field_value_type<id>;
+      const std::uint64_t value{details::capture::ordered_value<FrameType, id>(frame)};
+      return value >= details::capture::to_ordered(static_cast<Value>(range.low)) &&
+             value <= details::capture::to_ordered(static_cast<Value>(range.high));
+   }
+
+   // Decodes up to count records from [position, end), calling visit(FrameType) for each, and
+   // returns the end of the last complete one.
+   template<typename Visit>
+   static const std::uint8_t*
+   walk(const std::uint8_t* position,
+        const std::uint8_t* end,
+        std::size_t count,
+        std::vector<std::uint8_t>& scratch,
+        Visit&& visit)
+   {
+      typename delta::Values previous{};
+      for(; count > 0; --count) {
+         std::uint64_t length;
+         const std::size_t prefix{details::capture::read_varint(position, end, length)};
+         if(prefix == 0 || length > static_cast<std::size_t>(end - position) - prefix) {
+            break;
+         }
+         const std::uint8_t* const record{position + prefix};
+         if constexpr(delta::count == 0) {
+            if(length < FrameType::size) {
+               break;
+            }
+            visit(FrameType{record, static_cast<std::size_t>(length)});
+         }
+         else {
+            const std::size_t frame_size{
+              delta::restore(record, record + length, previous, scratch)};
+            if(frame_size == 0) {
+               break;
+            }
+            visit(FrameType{scratch.data(), frame_size});
+         }
+         position = record + length;
+      }
+      return position;
+   }
+
+   void
+   load_index()
+   {
+      const header_view header{data, header_frame::size};
+      std::array<std::uint8_t, 8> magic;
+      header.template extract<details::capture::Header::Magic>(magic);
+      std::uint16_t format_version;
+      header.template extract<details::capture::Header::Version>(format_version);
+      if(magic != details::capture::header_magic ||
+         format_version != details::capture::version) {
+         throw std::runtime_error{"gbee: not a capture segment"};
+      }
+
+      std::uint8_t index_count;
+      std::uint8_t delta_count;
+      std::uint32_t frame_size;
+      std::uint32_t block_frames;
+      header.template extract<details::capture::Header::IndexCount>(index_count);
+      header.template extract<details::capture::Header::DeltaCount>(delta_count);
+      header.template extract<details::capture::Header::FrameSize>(frame_size);
+      header.template extract<details::capture::Header::BlockFrames>(block_frames);
+      if(index_count != index::count || delta_count != delta::count ||
+         frame_size != FrameType::size || block_frames == 0) {
+         throw std::runtime_error{"gbee: capture segment has another layout"};
+      }
+
+      if(size >= header_frame::size + trailer_frame::size) {
+         const trailer_view trailer{data + size - trailer_frame::size, trailer_frame::size};
+         trailer.template extract<details::capture::Trailer::Magic>(magic);
+         if(magic == details::capture::trailer_magic) {
+            read_entries(trailer);
+            return;
+         }
+      }
+      rebuild(block_frames);
+   }
+
+   void
+   read_entries(const trailer_view& trailer)
+   {
+      std::uint64_t index_offset;
+      std::uint32_t count;
+      trailer.template extract<details::capture::Trailer::IndexOffset>(index_offset);
+      trailer.template extract<details::capture::Trailer::BlockCount>(count);
+      if(index_offset < header_frame::size ||
+         index_offset + std::uint64_t{count} * entry_group::size + trailer_frame::size != size) {
+         throw std::runtime_error{"gbee: corrupt capture segment"};
+      }
+
+      blocks.reserve(count);
+      for(std::uint32_t i = 0; i < count; ++i) {
+         const FrameView<0, entry_group> entry{data + index_offset + i * entry_group::size,
+                                               entry_group::size};
+         Block block;
+         entry.template extract<details::capture::Entry::Offset>(block.offset);
+         entry.template extract<details::capture::Entry::Size>(block.size);
+         entry.template extract<details::capture::Entry::Count>(block.count);
+         if constexpr(index::count > 0) {
+            entry.template extract<details::capture::Entry::Bounds>(block.bounds);
+         }
+         if(block.offset < header_frame::size || block.offset + block.size > index_offset) {
+            throw std::runtime_error{"gbee: corrupt capture segment"};
+         }
+         blocks.push_back(block);
+      }
+   }
+
+   // Recovers the blocks of a segment whose writer stopped before close(), up to the last
+   // complete record.
+   void
+   rebuild(std::size_t block_frames)
+   {
+      rebuilt = true;
+      std::vector<std::uint8_t> scratch;
+      const std::uint8_t* position{data + header_frame::size};
+      const std::uint8_t* const end{data + size};
+      while(position < end) {
+         Block block{static_cast<std::uint64_t>(position - data), 0, 0, index::empty()};
+         const std::uint8_t* const block_end{
+           walk(position, end, block_frames, scratch, [&block](const FrameType& frame) {
+              ++block.count;
+              index::add(block.bounds, frame);
+           })};
+         if(block.count == 0) {
+            break;
+         }
+         block.size = static_cast<std::uint32_t>(block_end - position);
+         blocks.push_back(block);
+         position = block_end;
+      }
+   }
+
+   const std::uint8_t* data;
+   std::size_t size;
+   std::vector<Block> blocks;
+   bool rebuilt{false};
+};
+
+} // namespace gbee
@@ -0,0 +1,253 @@
+//
+// Copyright (C) 2019 Tomasz Jankowski tomasz.jankowski.mail AT gmail.com>
+//
+// This is part of GBee library.
+//
+// GBee is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GBee is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <gbee/byte_order.hpp>
+#include <gbee/group.hpp>
+#include <type_traits>
+
+#if defined(__SSE4_2__)
+#   include <nmmintrin.h>
+#endif
+
+namespace gbee {
+
+namespace details::checksum {
+
+template<typename T, T polynomial>
+constexpr std::array<std::array<T, 256>, 8>
+make_tables()
+{
+   std::array<std::array<T, 256>, 8> tables{};
+   for(std::size_t i = 0; i < 256; ++i) {
+      T value{static_cast<T>(i)};
+      for(int bit = 0; bit < 8; ++bit) {
+         value = static_cast<T>((value & 1) ? (value >> 1) ^ polynomial : value >> 1);
+      }
+      tables[0][i] = value;
+   }
+   for(std::size_t slice = 1; slice < tables.size(); ++slice) {
+      for(std::size_t i = 0; i < 256; ++i) {
+         const T previous{tables[slice - 1][i]};
+         tables[slice][i] = static_cast<T>((previous >> 8) ^ tables[0][previous & 0xff]);
+      }
+   }
+   return tables;
+}
+
+template<typename T, T polynomial>
+inline constexpr std::array<std::array<T, 256>, 8> tables{make_tables<T, polynomial>()};
+
+// Polynomials are kept reflected, so x^0 is the most significant bit of T.
+template<typename T, T polynomial>
+constexpr T
+multiply(T a, T b)
+{
+   T product{0};
+   for(T mask = static_cast<T>(T{1} << (sizeof(T) * 8 - 1)); mask != 0; mask >>= 1) {
+      if(a & mask) {
+         product ^= b;
+      }
+      b = static_cast<T>((b & 1) ? (b >> 1) ^ polynomial : b >> 1);
+   }
+   return product;
+}
+
+template<typename T, T polynomial>
+constexpr std::array<T, sizeof(std::size_t) * 8 + 3>
+make_powers()
+{
+   std::array<T, sizeof(std::size_t) * 8 + 3> powers{};
+   powers[0] = static_cast<T>(T{1} << (sizeof(T) * 8 - 2));
+   for(std::size_t i = 1; i < powers.size(); ++i) {
+      powers[i] = multiply<T, polynomial>(powers[i - 1], powers[i - 1]);
+   }
+   return powers;
+}
+
+// x^(2^i) mod polynomial
+template<typename T, T polynomial>
+inline constexpr std::array<T, sizeof(std::size_t) * 8 + 3> powers{make_powers<T, polynomial>()};
+
+template<typename Algorithm>
+constexpr typename Algorithm::value_type
+compute(const std::uint8_t* data, std::size_t size)
+{
+   using value_type = typename Algorithm::value_type;
+   return static_cast<value_type>(Algorithm::update(Algorithm::initial, data, size) ^
+                                  Algorithm::final_xor);
+}
+
+// x^(8 * zero_bytes) mod polynomial, the factor that feeds zero_bytes zeros into a register.
+template<typename Algorithm>
+constexpr typename Algorithm::value_type
+zeros_power(std::size_t zero_bytes)
+{
+   using value_type = typename Algorithm::value_type;
+   constexpr auto& x2n = powers<value_type, Algorithm::polynomial>;
+   value_type power{static_cast<value_type>(x2n[0] << 1)};
+   for(std::size_t i = 3; zero_bytes != 0; zero_bytes >>= 1, ++i) {
+      if(zero_bytes & 1) {
+         power = multiply<value_type, Algorithm::polynomial>(x2n[i], power);
+      }
+   }
+   return power;
+}
+
+template<typename Algorithm>
+typename Algorithm::value_type
+shift(typename Algorithm::value_type state, std::size_t zero_bytes)
+{
+   using value_type = typename Algorithm::value_type;
+   return multiply<value_type, Algorithm::polynomial>(zeros_power<Algorithm>(zero_bytes), state);
+}
+
+template<typename Algorithm, std::size_t zero_bytes>
+constexpr std::array<std::array<typename Algorithm::value_type, 256>,
+                     sizeof(typename Algorithm::value_type)>
+make_shift_tables()
+{
+   using value_type = typename Algorithm::value_type;
+   constexpr value_type power{zeros_power<Algorithm>(zero_bytes)};
+   std::array<std::array<value_type, 256>, sizeof(value_type)> tables{};
+   for(std::size_t slice = 0; slice < tables.size(); ++slice) {
+      for(std::size_t i = 0; i < 256; ++i) {
+         tables[slice][i] = multiply<value_type, Algorithm::polynomial>(
+           power, static_cast<value_type>(i << (slice * 8)));
+      }
+   }
+   return tables;
+}
+
+template<typename Algorithm, std::size_t zero_bytes>
+inline constexpr std::array<std::array<typename Algorithm::value_type, 256>,
+                            sizeof(typename Algorithm::value_type)>
+  shift_tables{make_shift_tables<Algorithm, zero_bytes>()};
+
+// CRC is affine, so a changed span only contributes CRC(old ^ new) shifted past the bytes
+// following it; nothing else in the covered range has to be read again.
+template<typename Algorithm, std::size_t trailing_size>
+typename Algorithm::value_type
+patch(typename Algorithm::value_type checksum, const std::uint8_t* delta, std::size_t delta_size)
+{
+   using value_type = typename Algorithm::value_type;
+   constexpr auto& table = shift_tables<Algorithm, trailing_size>;
+   const value_type state{Algorithm::update(0, delta, delta_size)};
+   for(std::size_t slice = 0; slice < table.size(); ++slice) {
+      checksum ^= table[slice][(state >> (slice * 8)) & 0xff];
+   }
+   return checksum;
+}
+
+} // namespace details::checksum
+
+template<typename T, T reflected_polynomial, T initial_value, T final_xor_value>
+struct Crc
+{
+   static_assert(std::is_unsigned_v<T> && sizeof(T) <= 4);
+
+   using value_type = T;
+   static constexpr ByteOrder byte_order{ByteOrder::little};
+   static constexpr value_type polynomial{reflected_polynomial};
+   static constexpr value_type initial{initial_value};
+   static constexpr value_type final_xor{final_xor_value};
+
+   static constexpr value_type
+   update(value_type state, const std::uint8_t* data, std::size_t size)
+   {
+      constexpr auto& table = details::checksum::tables<value_type, polynomial>;
+      for(; size >= 8; data += 8, size -= 8) {
+         std::uint64_t word{};
+         details::byte_order::load<ByteOrder::little>(data, word);
+         word ^= state;
+         state = static_cast<value_type>(
+           table[7][word & 0xff] ^ table[6][(word >> 8) & 0xff] ^ table[5][(word >> 16) & 0xff] ^
+           table[4][(word >> 24) & 0xff] ^ table[3][(word >> 32) & 0xff] ^
+           table[2][(word >> 40) & 0xff] ^ table[1][(word >> 48) & 0xff] ^ table[0][word >> 56]);
+      }
+      for(; size > 0; ++data, --size) {
+         state = static_cast<value_type>((state >> 8) ^ table[0][(state ^ *data) & 0xff]);
+      }
+      return state;
+   }
+};
+
+// IEEE 802.15.4 FCS
+using Crc16Kermit = Crc<std::uint16_t, 0x8408, 0x0000, 0x0000>;
+
+struct Crc32c : public Crc<std::uint32_t, 0x82f63b78, 0xffffffff, 0xffffffff>
+{
+   static constexpr value_type
+   update(value_type state, const std::uint8_t* data, std::size_t size)
+   {
+#if defined(__SSE4_2__)
+      if(details::is_constant_evaluated()) {
+         return Crc::update(state, data, size);
+      }
+      std::uint64_t wide_state{state};
+      for(; size >= 8; data += 8, size -= 8) {
+         std::uint64_t word{};
+         std::memcpy(&word, data, sizeof(word));
+         wide_state = _mm_crc32_u64(wide_state, word);
+      }
+      state = static_cast<value_type>(wide_state);
+      for(; size > 0; ++data, --size) {
+         state = _mm_crc32_u8(state, *data);
+      }
+      return state;
+#else
+      return Crc::update(state, data, size);
+#endif
+   }
+};
+
+struct Preceding
+{
+   template<typename FrameType, auto checksum_id>
+   static constexpr std::size_t begin{0};
+
+   template<typename FrameType, auto checksum_id>
+   static constexpr std::size_t end{FrameType::template field_offset<checksum_id>};
+};
+
+template<auto first_id, auto last_id>
+struct FieldRange
+{
+   template<typename FrameType, auto checksum_id>
+   static constexpr std::size_t begin{FrameType::template field_bit_offset<first_id> / 8};
+
+   template<typename FrameType, auto checksum_id>
+   static constexpr std::size_t end{(FrameType::template field_bit_offset<last_id> +
+                                     FrameType::template field_type<last_id>::bit_size + 7) /
+                                    8};
+};
+
+template<auto initial_id, typename Algorithm, typename Range = Preceding>
+struct Checksum : public Field<initial_id, typename Algorithm::value_type, Algorithm::byte_order>
+{
+   using algorithm = Algorithm;
+   using range = Range;
+};
+
+} // namespace gbee
@@ -0,0 +1,304 @@
+//
+// Copyright (C) 2019 Tomasz Jankowski tomasz.jankowski.mail AT gmail.com>
+//
+// This is part of GBee library.
+//
+// GBee is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GBee is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <gbee/bounds.hpp>
+#include <gbee/frame.hpp>
+#include <gbee/helpers.hpp>
+#include <gbee/span.hpp>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace gbee {
+
+template<typename Group, auto initial_discriminant_id, auto... initial_values>
+struct OptionalGroup : public Group
+{
+   static_assert(sizeof...(initial_values) > 0);
+
+   static constexpr auto discriminant_id{initial_discriminant_id};
+
+   template<typename T>
+   static constexpr bool
+   is_present(const T& discriminant)
+   {
+      return ((discriminant == static_cast<T>(initial_values)) || ...);
+   }
+};
+
+namespace details::conditional {
+
+template<typename Group>
+struct is_optional : public std::false_type
+{};
+
+template<typename Group, auto discriminant_id, auto... values>
+struct is_optional<OptionalGroup<Group, discriminant_id, values...>> : public std::true_type
+{};
+
+template<auto id, typename Group>
+constexpr bool
+is_discriminant()
+{
+   if constexpr(is_optional<Group>::value) {
+      return is_same_value<id, Group::discriminant_id>();
+   }
+   else {
+      return false;
+   }
+}
+
+template<typename... Groups>
+constexpr std::size_t
+first_optional_index()
+{
+   constexpr std::array<bool, sizeof...(Groups)> optional{{is_optional<Groups>::value...}};
+   for(std::size_t i = 0; i < optional.size(); ++i) {
+      if(optional[i]) {
+         return i;
+      }
+   }
+   return optional.size();
+}
+
+template<typename... Groups>
+inline constexpr std::size_t optional_count{(std::size_t{is_optional<Groups>::value} + ... + 0)};
+
+template<typename... Groups>
+constexpr std::array<std::size_t, optional_count<Groups...>>
+optional_indexes()
+{
+   constexpr std::array<bool, sizeof...(Groups)> optional{{is_optional<Groups>::value...}};
+   std::array<std::size_t, optional_count<Groups...>> indexes{};
+   std::size_t optional_index{0};
+   for(std::size_t i = 0; i < optional.size(); ++i) {
+      if(optional[i]) {
+         indexes[optional_index++] = i;
+      }
+   }
+   return indexes;
+}
+
+template<typename... Groups>
+constexpr auto
+make_layouts()
+{
+   constexpr std::size_t group_count{sizeof...(Groups)};
+   constexpr std::size_t optional_count{details::conditional::optional_count<Groups...>};
+   static_assert(optional_count <= 8, "too many optional groups for a layout table");
+   static_assert((Groups::size + ... + 0) <= UINT16_MAX);
+
+   constexpr std::array<std::size_t, group_count> sizes{{Groups::size...}};
+   constexpr std::array<bool, group_count> optional{{is_optional<Groups>::value...}};
+
+   std::array<std::array<std::uint16_t, group_count + 1>, std::size_t{1} << optional_count> table{};
+   for(std::size_t key = 0; key < table.size(); ++key) {
+      std::size_t offset{0};
+      std::size_t optional_index{0};
+      for(std::size_t group = 0; group < group_count; ++group) {
+         table[key][group] = static_cast<std::uint16_t>(offset);
+         const bool present{!optional[group] || ((key >> optional_index) & 1) != 0};
+         optional_index += optional[group] ? 1 : 0;
+         offset += present ? sizes[group] : 0;
+      }
+      table[key][group_count] = static_cast<std::uint16_t>(offset);
+   }
+   return table;
+}
+
+} // namespace details::conditional
+
+template<typename Byte, typename Policy, std::size_t extra_size, typename... Groups>
+class BasicConditionalFrame
+{
+   static_assert(std::is_same_v<std::remove_const_t<Byte>, std::uint8_t>);
+   static_assert(are_types_unique<typename Groups::id_type...>);
+
+ private:
+   static constexpr std::size_t group_count{sizeof...(Groups)};
+
+   static constexpr std::size_t fixed_count{
+     details::conditional::first_optional_index<Groups...>()};
+
+   static constexpr auto optional_indexes{details::conditional::optional_indexes<Groups...>()};
+
+   static constexpr auto layouts{details::conditional::make_layouts<Groups...>()};
+
+   using layout_type = typename decltype(layouts)::value_type;
+
+   template<std::size_t index>
+   using group_at = details::type_at<index, Groups...>;
+
+   template<typename Id>
+   static constexpr std::size_t group_index{
+     details::type_index<std::decay_t<Id>, typename Groups::id_type...>()};
+
+   template<auto id>
+   static constexpr bool is_discriminant{
+     (details::conditional::is_discriminant<id, Groups>() || ...)};
+
+ public:
+   static constexpr std::size_t min_size{layouts.front()[group_count]};
+   static constexpr std::size_t max_size{layouts.back()[group_count]};
+
+   static constexpr std::size_t required_size{max_size + extra_size};
+
+   template<auto id>
+   using field_value_type =
+     typename group_at<group_index<decltype(id)>>::template field_value_type<id>;
+
+   template<std::size_t array_size>
+   explicit BasicConditionalFrame(std::array<std::uint8_t, array_size>& initial_buffer)
+     : BasicConditionalFrame{initial_buffer.data(), array_size}
+   {}
+
+   template<std::size_t array_size,
+            typename T = Byte,
+            typename = std::enable_if_t<std::is_const_v<T>>>
+   explicit BasicConditionalFrame(const std::array<std::uint8_t, array_size>& initial_buffer)
+     : BasicConditionalFrame{initial_buffer.data(), array_size}
+   {}
+
+   BasicConditionalFrame(Byte* initial_buffer, std::size_t initial_buffer_size)
+     : buffer{initial_buffer}, buffer_size{initial_buffer_size}
+   {
+      Policy::check_buffer(buffer_size, min_size);
+      refresh();
+   }
+
+   void
+   refresh()
+   {
+      layout = &layouts[key(std::make_index_sequence<optional_indexes.size()>{})];
+      Policy::check_length(buffer_size, size() + extra_size);
+   }
+
+   std::size_t
+   size() const
+   {
+      return (*layout)[group_count];
+   }
+
+   template<typename Id>
+   bool
+   has() const
+   {
+      return has_group<group_index<Id>>();
+   }
+
+   // Injecting a discriminant refreshes the layout, so the optional groups it selects can be
+   // accessed right away.
+   template<auto id, typename T>
+   void
+   inject(const T& value)
+   {
+      static_assert(!std::is_const_v<Byte>, "cannot inject into a read-only frame");
+      constexpr std::size_t index{group_index<decltype(id)>};
+      Policy::check_present(has_group<index>());
+      group_at<index>::template inject<id, Policy>(buffer, buffer_size, value, offset<index>());
+      if constexpr(is_discriminant<id>) {
+         refresh();
+      }
+   }
+
+   template<auto id, typename T>
+   void
+   extract(T& value) const
+   {
+      constexpr std::size_t index{group_index<decltype(id)>};
+      Policy::check_present(has_group<index>());
+      group_at<index>::template extract<id, Policy>(buffer, buffer_size, value, offset<index>());
+   }
+
+   Span<Byte>
+   payload() const
+   {
+      const std::size_t groups_size{size()};
+      Policy::check_access(buffer_size, groups_size);
+      return {buffer + groups_size, buffer_size < groups_size ? 0 : buffer_size - groups_size};
+   }
+
+   Byte* buffer;
+   const std::size_t buffer_size;
+
+ private:
+   template<std::size_t index>
+   std::size_t
+   offset() const
+   {
+      static_assert(index < group_count);
+      if constexpr(index < fixed_count) {
+         return layouts.front()[index];
+      }
+      else {
+         return (*layout)[index];
+      }
+   }
+
+   template<std::size_t index>
+   bool
+   has_group() const
+   {
+      static_assert(index < group_count);
+      if constexpr(index < fixed_count) {
+         return true;
+      }
+      else {
+         return (*layout)[index] != (*layout)[index + 1];
+      }
+   }
+
+   template<std::size_t index>
+   bool
+   is_present() const
+   {
+      using group_type = group_at<optional_indexes[index]>;
+      constexpr auto discriminant_id{group_type::discriminant_id};
+      constexpr std::size_t discriminant_index{group_index<decltype(discriminant_id)>};
+      static_assert(discriminant_index < fixed_count,
+                    "discriminant has to precede the first optional group");
+
+      field_value_type<discriminant_id> discriminant;
+      extract<discriminant_id>(discriminant);
+      return group_type::is_present(discriminant);
+   }
+
+   template<std::size_t... indexes>
+   std::size_t
+   key(std::index_sequence<indexes...>) const
+   {
+      return ((std::size_t{is_present<indexes>()} << indexes) | ... | 0);
+   }
+
+   const layout_type* layout;
+};
+
+template<std::size_t extra_size, typename... Groups>
+using ConditionalFrame = BasicConditionalFrame<std::uint8_t, Unchecked, extra_size, Groups...>;
+
+template<std::size_t extra_size, typename... Groups>
+using ConditionalFrameView =
+  BasicConditionalFrame<const std::uint8_t, Unchecked, extra_size, Groups...>;
+
+} // namespace gbee
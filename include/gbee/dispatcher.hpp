@@ -0,0 +1,171 @@
+//
+// Copyright (C) 2019 Tomasz Jankowski tomasz.jankowski.mail AT gmail.com>
+//
+// This is part of GBee library.
+//
+// GBee is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GBee is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <gbee/frame.hpp>
+#include <gbee/helpers.hpp>
+#include <type_traits>
+
+namespace gbee {
+
+template<typename HeaderFrame, auto initial_id>
+struct Discriminant
+{
+   using frame_type = HeaderFrame;
+   using value_type = typename HeaderFrame::template field_value_type<initial_id>;
+   static constexpr auto id{initial_id};
+};
+
+template<auto initial_value, typename FrameType>
+struct Case
+{
+   using frame_type = FrameType;
+   static constexpr auto value{initial_value};
+};
+
+namespace details::dispatcher {
+
+template<typename T>
+constexpr auto
+to_integer(T value)
+{
+   if constexpr(std::is_enum_v<T>) {
+      return static_cast<std::underlying_type_t<T>>(value);
+   }
+   else {
+      return value;
+   }
+}
+
+template<typename T>
+constexpr unsigned long long
+distance(T from, T to)
+{
+   // Modular arithmetic keeps signed discriminants right and sends values below `from` far away.
+   return static_cast<unsigned long long>(to_integer(to)) -
+          static_cast<unsigned long long>(to_integer(from));
+}
+
+template<typename T, auto... values>
+inline constexpr T min_value{
+  static_cast<T>(std::min({to_integer(static_cast<T>(values))...}))};
+
+template<typename T, auto... values>
+inline constexpr T max_value{
+  static_cast<T>(std::max({to_integer(static_cast<T>(values))...}))};
+
+// Smallest buffer a case frame can be built over: its fixed groups for a conditional frame, the
+// whole frame otherwise.
+template<typename FrameType, typename = void>
+inline constexpr std::size_t min_size{FrameType::required_size};
+
+template<typename FrameType>
+inline constexpr std::size_t
+  min_size<FrameType, std::void_t<decltype(FrameType::min_size)>>{FrameType::min_size};
+
+} // namespace details::dispatcher
+
+template<typename DiscriminantType, typename... Cases>
+class FrameDispatcher
+{
+   using discriminant_type = typename DiscriminantType::value_type;
+   using header_frame = typename DiscriminantType::frame_type;
+   using header_group = typename header_frame::template group_type<DiscriminantType::id>;
+
+   static_assert(sizeof...(Cases) > 0);
+   static_assert(std::is_integral_v<discriminant_type> || std::is_enum_v<discriminant_type>);
+   static_assert(are_values_unique<static_cast<discriminant_type>(Cases::value)...>);
+
+   static constexpr auto min_value{
+     details::dispatcher::min_value<discriminant_type, Cases::value...>};
+   static constexpr auto max_value{
+     details::dispatcher::max_value<discriminant_type, Cases::value...>};
+
+ public:
+   static constexpr std::size_t table_size{
+     static_cast<std::size_t>(details::dispatcher::distance(min_value, max_value)) + 1};
+   static_assert(table_size <= 4096, "discriminant values are too sparse for a jump table");
+
+   template<typename Byte, typename Handler>
+   static bool
+   dispatch(Byte* buffer, std::size_t buffer_size, Handler&& handler)
+   {
+      if(buffer_size < header_frame::size) {
+         return false;
+      }
+
+      constexpr auto id{DiscriminantType::id};
+      constexpr std::size_t group_offset{header_frame::template field_offset<id> -
+                                         header_group::template offset<id>::value};
+      discriminant_type discriminant;
+      header_group::template extract<id>(buffer, buffer_size, discriminant, group_offset);
+
+      const unsigned long long index{details::dispatcher::distance(min_value, discriminant)};
+      if(index >= table_size) {
+         return false;
+      }
+
+      const auto entry{table<Byte, std::remove_reference_t<Handler>>[index]};
+      if(entry == nullptr) {
+         return false;
+      }
+      return entry(buffer, buffer_size, handler);
+   }
+
+ private:
+   template<typename Byte, typename Handler>
+   using entry_type = bool (*)(Byte*, std::size_t, Handler&);
+
+   // The header fits the buffer, but the frame selected by the discriminant may not.
+   template<typename Case, typename Byte, typename Handler>
+   static bool
+   invoke(Byte* buffer, std::size_t buffer_size, Handler& handler)
+   {
+      static_assert(std::is_constructible_v<typename Case::frame_type, Byte*, std::size_t>,
+                    "frame type cannot be built over this buffer");
+      if(buffer_size < details::dispatcher::min_size<typename Case::frame_type>) {
+         return false;
+      }
+      handler(typename Case::frame_type{buffer, buffer_size});
+      return true;
+   }
+
+   template<typename Byte, typename Handler>
+   static constexpr std::array<entry_type<Byte, Handler>, table_size>
+   make_table()
+   {
+      std::array<entry_type<Byte, Handler>, table_size> entries{};
+      ((entries[details::dispatcher::distance(min_value,
+                                              static_cast<discriminant_type>(Cases::value))] =
+          &invoke<Cases, Byte, Handler>),
+       ...);
+      return entries;
+   }
+
+   template<typename Byte, typename Handler>
+   static constexpr std::array<entry_type<Byte, Handler>, table_size> table{
+     make_table<Byte, Handler>()};
+};
+
+} // namespace gbee
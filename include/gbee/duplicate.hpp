@@ -0,0 +1,306 @@
+//
+// Copyright (C) 2019 Tomasz Jankowski tomasz.jankowski.mail AT gmail.com>
+//
+// This is part of GBee library.
+//
+// GBee is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GBee is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <gbee/byte_order.hpp>
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace gbee {
+
+// Fixed capacity table remembering which frames were seen within the last window ticks, keyed
+// on the bytes of the listed fields, e.g. the source address and sequence number of a broadcast.
+// Several threads may call insert() and contains() at once: slots are claimed with a single
+// compare-and-swap on a stamp holding the insertion time and a hash tag, and readers validate
+// the key they read against that stamp. A key only probes the stamps sharing its cache line;
+// expired slots are reused in place and when all of them are live the oldest one is replaced,
+// so an overloaded table lets duplicates through rather than dropping new frames.
+template<typename FrameType, std::size_t capacity, auto... ids>
+class DuplicateTable
+{
+   static_assert(sizeof...(ids) > 0);
+   static_assert(capacity > 0 && (capacity & (capacity - 1)) == 0,
+                 "capacity has to be a power of two");
+   static_assert(((FrameType::template field_bit_offset<ids> % 8 == 0) && ...),
+                 "key fields have to be byte aligned");
+
+ public:
+   static constexpr std::size_t key_size{(0 + ... + FrameType::template field_type<ids>::size)};
+
+   static constexpr std::size_t cache_line_size{64};
+
+   // Slots inspected for one key: the stamps of one cache line.
+   static constexpr std::size_t bucket_size{capacity < 8 ? capacity : 8};
+
+   // Times are ticks of any clock wrapping at 32 bits; window has to stay below 2^31 ticks.
+   explicit DuplicateTable(std::uint32_t initial_window)
+     : window{initial_window},
+       stamps{static_cast<std::atomic<std::uint64_t>*>(::operator new(
+         sizeof(std::atomic<std::uint64_t>) * capacity, std::align_val_t{cache_line_size}))}
+   {
+      for(std::size_t index = 0; index < capacity; ++index) {
+         new(&stamps[index]) std::atomic<std::uint64_t>{0};
+      }
+   }
+
+   DuplicateTable(const DuplicateTable&) = delete;
+
+   DuplicateTable&
+   operator=(const DuplicateTable&) = delete;
+
+   ~DuplicateTable()
+   {
+      ::operator delete(stamps, std::align_val_t{cache_line_size});
+   }
+
+   // Records the frame and returns true unless its key was inserted during the window before
+   // now, in which case the frame is a duplicate and false is returned.
+   template<typename Frame>
+   bool
+   insert(const Frame& frame, std::uint32_t now)
+   {
+      const Key key{make_key(frame.buffer)};
+      const std::uint64_t hash{hash_key(key)};
+      const std::uint64_t claimed{std::uint64_t{now} << 32 | tag_of(hash)};
+      for(;;) {
+         Stamps bucket_stamps;
+         const Probe match{find(key, hash, now, bucket_stamps)};
+         if(match.result == Probe::found) {
+            return false;
+         }
+         if(match.result == Probe::changed) {
+            continue;
+         }
+
+         const Probe probe{claimable(hash, now, bucket_stamps)};
+
+         std::atomic<std::uint64_t>& stamp{stamps[probe.index]};
+         std::uint64_t expected{probe.stamp};
+         if(!stamp.compare_exchange_strong(expected, claimed, std::memory_order_acq_rel,
+                                           std::memory_order_relaxed)) {
+            continue;
+         }
+         // Keeps the key stores after the claim: a reader that sees one of the new key words in
+         // its validation also sees the claimed stamp, not the one it read first.
+         std::atomic_thread_fence(std::memory_order_release);
+         for(std::size_t i = 0; i < key_words; ++i) {
+            keys[probe.index][i].store(key[i], std::memory_order_relaxed);
+         }
+         stamp.store(claimed | ready, std::memory_order_release);
+         return true;
+      }
+   }
+
+   template<typename Frame>
+   bool
+   contains(const Frame& frame, std::uint32_t now) const
+   {
+      const Key key{make_key(frame.buffer)};
+      const std::uint64_t hash{hash_key(key)};
+      for(;;) {
+         Stamps bucket_stamps;
+         const Probe probe{find(key, hash, now, bucket_stamps)};
+         if(probe.result != Probe::changed) {
+            return probe.result == Probe::found;
+         }
+      }
+   }
+
+ private:
+   static constexpr std::size_t key_words{(key_size + 7) / 8};
+
+   using Key = std::array<std::uint64_t, key_words>;
+
+   using Stamps = std::array<std::uint64_t, bucket_size>;
+
+   // Stamp layout: insertion time in the upper half, a non-zero hash tag in bits 31..1 and the
+   // ready flag in bit 0, set once the key words are written. Zero marks a slot never used.
+   static constexpr std::uint64_t ready{1};
+
+   static constexpr std::uint64_t tag_mask{0xfffffffe};
+
+   struct Probe
+   {
+      enum Result
+      {
+         found,
+         missing,
+         changed
+      };
+
+      Result result;
+      std::size_t index;
+      std::uint64_t stamp;
+   };
+
+   // Byte position of each key field within the key words.
+   static constexpr std::array<std::size_t, sizeof...(ids)> key_positions{[] {
+      std::array<std::size_t, sizeof...(ids)> positions{};
+      const std::array<std::size_t, sizeof...(ids)> sizes{
+        {FrameType::template field_type<ids>::size...}};
+      for(std::size_t i = 1; i < positions.size(); ++i) {
+         positions[i] = positions[i - 1] + sizes[i - 1];
+      }
+      return positions;
+   }()};
+
+   // Fields of 1, 2, 4 or 8 bytes that do not straddle a key word are read with one load and
+   // shifted into place; building the key in a byte array instead and reading it back as words
+   // stalls on store forwarding.
+   template<auto id, std::size_t position>
+   static void
+   pack(const std::uint8_t* buffer, Key& key)
+   {
+      constexpr std::size_t size{FrameType::template field_type<id>::size};
+      const std::uint8_t* field{buffer + FrameType::template field_offset<id>};
+      if constexpr((size == 1 || size == 2 || size == 4 || size == 8) && position % 8 + size <= 8) {
+         typename details::byte_order::word<size>::type value;
+         std::memcpy(&value, field, size);
+         key[position / 8] |= std::uint64_t{value} << position % 8 * 8;
+      }
+      else {
+         for(std::size_t i = 0; i < size; ++i) {
+            key[(position + i) / 8] |= std::uint64_t{field[i]} << (position + i) % 8 * 8;
+         }
+      }
+   }
+
+   template<std::size_t... indexes>
+   static Key
+   make_key(const std::uint8_t* buffer, std::index_sequence<indexes...>)
+   {
+      Key key{};
+      (pack<ids, key_positions[indexes]>(buffer, key), ...);
+      return key;
+   }
+
+   static Key
+   make_key(const std::uint8_t* buffer)
+   {
+      return make_key(buffer, std::make_index_sequence<sizeof...(ids)>{});
+   }
+
+   static std::uint64_t
+   hash_key(const Key& key)
+   {
+      std::uint64_t hash{0};
+      for(std::uint64_t word : key) {
+         hash = (hash ^ word) * 0x9e3779b97f4a7c15;
+         hash ^= hash >> 29;
+      }
+      return hash;
+   }
+
+   static std::uint64_t
+   tag_of(std::uint64_t hash)
+   {
+      return (hash >> 32 | 2) & tag_mask;
+   }
+
+   // Ticks since the stamp was taken; stamps a bit ahead of now, taken by another thread with
+   // a later clock reading, count as just inserted.
+   static std::uint32_t
+   age(std::uint64_t stamp, std::uint32_t now)
+   {
+      const std::int32_t elapsed{static_cast<std::int32_t>(now - (stamp >> 32))};
+      return elapsed < 0 ? 0 : static_cast<std::uint32_t>(elapsed);
+   }
+
+   static std::size_t
+   bucket_of(std::uint64_t hash)
+   {
+      return hash & (capacity - 1) & ~(bucket_size - 1);
+   }
+
+   // Looks for a live slot holding key, keeping the stamps read in bucket_stamps. Key words are
+   // only compared for matching tags.
+   Probe
+   find(const Key& key, std::uint64_t hash, std::uint32_t now, Stamps& bucket_stamps) const
+   {
+      const std::uint64_t tag{tag_of(hash)};
+      const std::size_t bucket{bucket_of(hash)};
+      unsigned matches{0};
+      for(std::size_t i = 0; i < bucket_size; ++i) {
+         bucket_stamps[i] = stamps[bucket + i].load(std::memory_order_relaxed);
+         matches |= static_cast<unsigned>((bucket_stamps[i] & tag_mask) == tag) << i;
+      }
+      std::atomic_thread_fence(std::memory_order_acquire);
+
+      for(std::size_t i = 0; matches != 0; ++i, matches >>= 1) {
+         const std::uint64_t stamp{bucket_stamps[i]};
+         if(!(matches & 1) || age(stamp, now) >= window) {
+            continue;
+         }
+         // A matching tag still being written is taken for the same key; a collision of two
+         // live 31 bit tags in one bucket is far rarer than a lost duplicate.
+         if(!(stamp & ready)) {
+            return Probe{Probe::found, bucket + i, stamp};
+         }
+         bool same{true};
+         for(std::size_t word = 0; word < key_words; ++word) {
+            same &= keys[bucket + i][word].load(std::memory_order_relaxed) == key[word];
+         }
+         std::atomic_thread_fence(std::memory_order_acquire);
+         if(stamps[bucket + i].load(std::memory_order_relaxed) != stamp) {
+            return Probe{Probe::changed, bucket + i, stamp};
+         }
+         if(same) {
+            return Probe{Probe::found, bucket + i, stamp};
+         }
+      }
+      return Probe{Probe::missing, capacity, 0};
+   }
+
+   // The slot a missing key takes: the first unused or expired one of its bucket, else the
+   // oldest. It is picked from the stamps find() saw, so two threads missing the same key pick
+   // the same slot and only one claims it. Unused and expired slots count as window ticks old,
+   // which keeps the pass free of data dependent branches.
+   Probe
+   claimable(std::uint64_t hash, std::uint32_t now, const Stamps& bucket_stamps) const
+   {
+      const std::size_t bucket{bucket_of(hash)};
+      Probe probe{Probe::missing, bucket, bucket_stamps[0]};
+      std::uint32_t oldest_age{0};
+      for(std::size_t i = 0; i < bucket_size; ++i) {
+         const std::uint64_t stamp{bucket_stamps[i]};
+         const std::uint32_t unused{0u - std::uint32_t{stamp == 0}};
+         const std::uint32_t stamp_age{std::min(age(stamp, now) | unused, window)};
+         const bool older{stamp_age > oldest_age};
+         probe.index = older ? bucket + i : probe.index;
+         probe.stamp = older ? stamp : probe.stamp;
+         oldest_age = older ? stamp_age : oldest_age;
+      }
+      return probe;
+   }
+
+   const std::uint32_t window;
+   std::atomic<std::uint64_t>* const stamps;
+   std::unique_ptr<std::array<std::atomic<std::uint64_t>, key_words>[]> keys{
+     new std::array<std::atomic<std::uint64_t>, key_words>[capacity]};
+};
+
+} // namespace gbee
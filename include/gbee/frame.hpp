@@ -21,100 +21,582 @@
 
 #include <array>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <gbee/bounds.hpp>
+#include <gbee/byte_order.hpp>
+#include <gbee/checksum.hpp>
 #include <gbee/helpers.hpp>
+#include <gbee/repeated.hpp>
+#include <gbee/span.hpp>
+#include <limits>
+#include <stdexcept>
+#include <tuple>
 #include <type_traits>
+#include <utility>
 
 namespace gbee {
 
 namespace details::frame {
-template<typename Id, typename Group>
-struct lookup_group_base : public std::enable_if<std::is_same_v<Id, typename Group::id_type>, Group>
-{};
+template<typename Id, typename... Groups>
+inline constexpr std::size_t index{[] {
+   constexpr std::size_t found{type_index<Id, typename Groups::id_type...>()};
+   static_assert(found < sizeof...(Groups));
+   return found;
+}()};
 
 template<typename Id, typename... Groups>
-struct lookup_group : public lookup_group_base<Id, Groups>...
-{};
+struct lookup_group
+{
+   using type = type_at<index<Id, Groups...>, Groups...>;
+};
 
-template<bool found, typename Id, std::size_t current_value, typename...>
-struct offset_helper;
+template<std::size_t... values>
+constexpr std::array<std::size_t, sizeof...(values)>
+exclusive_prefix_sums()
+{
+   std::array<std::size_t, sizeof...(values)> sums{};
+   std::size_t sum{0};
+   std::size_t index{0};
+   ((sums[index++] = sum, sum += values), ...);
+   return sums;
+}
+
+template<typename... Groups>
+inline constexpr std::array<std::size_t, sizeof...(Groups)> offsets{
+  exclusive_prefix_sums<Groups::size...>()};
+
+template<typename Id, typename... Groups>
+struct offset
+{
+   static constexpr std::size_t value{offsets<Groups...>[index<Id, Groups...>]};
+};
 
-template<typename Id, std::size_t current_value, typename Group, typename... Groups>
-struct offset_helper<true, Id, current_value, Group, Groups...>
-  : public offset_helper<true, Id, current_value, Groups...>
+// Copy plan of inject_all: every scalar is shifted into the little endian word of the 8 byte window
+// holding it, so a window costs one store instead of one per field. extract_all keeps one load
+// per field, as a narrow load costs less than the shift and mask taking the field out of a word.
+template<typename Field, typename = void>
+struct is_array : std::false_type
 {};
 
-template<typename Id, std::size_t current_value, typename Group, typename... Groups>
-struct offset_helper<false, Id, current_value, Group, Groups...>
-  : public offset_helper<std::is_same_v<typename Group::id_type, Id>,
-                         Id,
-                         std::is_same_v<typename Group::id_type, Id> ? current_value
-                                                                     : current_value + Group::size,
-                         Groups...>
+template<typename Field>
+struct is_array<Field, std::void_t<typename Field::element_type>> : std::true_type
 {};
 
-template<bool found, typename Id, std::size_t current_value>
-struct offset_helper<found, Id, current_value>
+// Larger arrays are cheaper to copy as a block than to shift element by element.
+inline constexpr std::size_t max_packed_array_size{32};
+
+template<typename Field>
+constexpr bool
+is_packable()
 {
-   static_assert(found);
-   static constexpr std::size_t value{current_value};
-};
+   if constexpr(Field::is_bit_field) {
+      return true;
+   }
+   else if constexpr(is_array<Field>::value) {
+      return byte_order::is_swappable<typename Field::element_type> &&
+             Field::size <= max_packed_array_size;
+   }
+   else {
+      return byte_order::is_swappable<typename Field::value_type>;
+   }
+}
 
-template<typename Id, typename... Groups>
-struct offset : public offset_helper<false, Id, 0, Groups...>
-{};
+constexpr void
+pack_bits(std::uint64_t* words, std::size_t bit_offset, std::size_t bit_size, std::uint64_t bits)
+{
+   const std::size_t shift{bit_offset % 64};
+   words[bit_offset / 64] |= bits << shift;
+   if(shift + bit_size > 64) {
+      words[bit_offset / 64 + 1] |= bits >> (64 - shift);
+   }
+}
+
+template<ByteOrder order, typename T>
+constexpr std::uint64_t
+to_bits(const T& value)
+{
+   std::array<std::uint8_t, sizeof(T)> bytes{};
+   byte_order::store<order>(bytes.data(), value);
+   typename byte_order::word<sizeof(T)>::type bits{};
+   byte_order::load<ByteOrder::little>(bytes.data(), bits);
+   return bits;
+}
+
+template<typename Field>
+constexpr void
+pack(std::uint64_t* words, std::size_t bit_offset, const typename Field::value_type& value)
+{
+   if constexpr(Field::is_bit_field) {
+      std::uint64_t bits{0};
+      Field::template store<0>(bits, value);
+      pack_bits(words, bit_offset, Field::bit_size, bits);
+   }
+   else if constexpr(is_array<Field>::value) {
+      constexpr std::size_t element_bit_size{sizeof(typename Field::element_type) * 8};
+      for(std::size_t i = 0; i < Field::count; ++i) {
+         pack_bits(words, bit_offset + i * element_bit_size, element_bit_size,
+                   to_bits<Field::byte_order>(value[i]));
+      }
+   }
+   else {
+      pack_bits(words, bit_offset, Field::bit_size, to_bits<Field::byte_order>(value));
+   }
+}
+
+// A last window shorter than 8 bytes is stored as the last 8 bytes of the frame, overlapping the
+// window before it, or as 4, 2 and 1 byte pieces when the whole frame is shorter than 8 bytes.
+template<std::size_t size>
+constexpr void
+store_words(std::uint8_t* destination, const std::uint64_t* words)
+{
+   constexpr std::size_t full{size / 8};
+   constexpr std::size_t rest{size % 8};
+   for(std::size_t i = 0; i < full; ++i) {
+      byte_order::store<ByteOrder::little>(destination + i * 8, words[i]);
+   }
+   if constexpr(rest != 0 && full != 0) {
+      const std::uint64_t last{(words[full - 1] >> (rest * 8)) | (words[full] << (64 - rest * 8))};
+      byte_order::store<ByteOrder::little>(destination + size - 8, last);
+   }
+   else if constexpr(rest != 0) {
+      std::uint64_t word{words[0]};
+      if constexpr((rest & 4) != 0) {
+         byte_order::store<ByteOrder::little>(destination, static_cast<std::uint32_t>(word));
+         destination += 4;
+         word >>= 32;
+      }
+      if constexpr((rest & 2) != 0) {
+         byte_order::store<ByteOrder::little>(destination, static_cast<std::uint16_t>(word));
+         destination += 2;
+         word >>= 16;
+      }
+      if constexpr((rest & 1) != 0) {
+         *destination = static_cast<std::uint8_t>(word);
+      }
+   }
+}
+
+template<typename Fields>
+struct plan;
+
+template<typename... Fields>
+struct plan<std::tuple<Fields...>>
+{
+   static constexpr bool is_packable{(frame::is_packable<Fields>() && ...)};
+
+   static constexpr std::array<std::size_t, sizeof...(Fields)> bit_offsets{
+     exclusive_prefix_sums<Fields::bit_size...>()};
+
+   template<std::size_t size, typename Values>
+   static constexpr void
+   inject(std::uint8_t* destination, const Values& values)
+   {
+      std::array<std::uint64_t, (size + 7) / 8> words{};
+      pack_all(words.data(), values, std::index_sequence_for<Fields...>{});
+      store_words<size>(destination, words.data());
+   }
+
+ private:
+   template<typename Values, std::size_t... indexes>
+   static constexpr void
+   pack_all(std::uint64_t* words, const Values& values, std::index_sequence<indexes...>)
+   {
+      (pack<Fields>(words, bit_offsets[indexes], std::get<indexes>(values)), ...);
+   }
+};
 
 } // namespace details::frame
 
-template<std::size_t extra_size, typename... Groups>
-class Frame
+template<typename Byte, typename Policy, std::size_t extra_size, typename... Groups>
+class BasicFrame
 {
+   static_assert(std::is_same_v<std::remove_const_t<Byte>, std::uint8_t>);
    static_assert(are_types_unique<typename Groups::id_type...>);
 
  private:
-   template<typename Id>
-   struct lookup_group : public details::frame::lookup_group<Id, Groups...>::type
-   {};
-
    template<typename Id>
    struct offset : public details::frame::offset<Id, Groups...>
    {};
 
  public:
-   static constexpr std::size_t size{(lookup_group<typename Groups::id_type>::size + ...)};
+   static constexpr std::size_t size{(0 + ... + Groups::size)};
+
+   static constexpr std::size_t required_size{size + extra_size};
+
+   using policy_type = Policy;
+
+   // Alignment the policy guarantees for buffer.
+   static constexpr std::size_t alignment{details::buffer_alignment<Policy>};
+
+   template<auto id>
+   using group_type = typename details::frame::lookup_group<decltype(id), Groups...>::type;
+
+   template<auto id>
+   using field_type = typename group_type<id>::template lookup_field<id>;
+
+   template<auto id>
+   using field_value_type = typename group_type<id>::template field_value_type<id>;
+
+   template<auto id>
+   static constexpr std::size_t field_offset{offset<decltype(id)>::value +
+                                             group_type<id>::template offset<id>::value};
+
+   template<auto id>
+   static constexpr std::size_t field_bit_offset{offset<decltype(id)>::value * 8 +
+                                                 group_type<id>::template offset<id>::bit_value};
 
    template<std::size_t array_size>
-   explicit Frame(std::array<std::uint8_t, array_size>& initial_buffer)
-     : buffer{initial_buffer.data()}, buffer_size{array_size}
+   constexpr explicit BasicFrame(std::array<std::uint8_t, array_size>& initial_buffer)
+     : BasicFrame{initial_buffer.data(), array_size}
+   {}
+
+   template<std::size_t array_size,
+            typename T = Byte,
+            typename = std::enable_if_t<std::is_const_v<T>>>
+   constexpr explicit BasicFrame(const std::array<std::uint8_t, array_size>& initial_buffer)
+     : BasicFrame{initial_buffer.data(), array_size}
+   {}
+
+   constexpr BasicFrame(Byte* initial_buffer, std::size_t initial_buffer_size)
+     : buffer{initial_buffer}, buffer_size{initial_buffer_size}
    {
-      // TODO Throw exception if array_size < size?
+      Policy::check_buffer(buffer_size, required_size);
+      if constexpr(alignment > 1) {
+         if(!details::is_constant_evaluated()) {
+            Policy::check_alignment(reinterpret_cast<std::uintptr_t>(buffer), alignment);
+         }
+      }
    }
 
-   bool
+   template<typename OtherByte,
+            typename = std::enable_if_t<std::is_convertible_v<OtherByte*, Byte*>>>
+   constexpr BasicFrame(const BasicFrame<OtherByte, Policy, extra_size, Groups...>& other)
+     : buffer{other.buffer}, buffer_size{other.buffer_size}
+   {}
+
+   constexpr bool
    has_valid_buffer_size() const
    {
-      return buffer_size >= (size + extra_size);
+      return buffer_size >= required_size;
    }
 
    template<auto id, typename T>
-   void
+   constexpr void
    inject(const T& value)
    {
-      using group_type = typename details::frame::lookup_group<decltype(id), Groups...>::type;
+      static_assert(!std::is_const_v<Byte>, "cannot inject into a read-only frame");
       constexpr std::size_t base_offset{offset<decltype(id)>::value};
-      group_type::template inject<id>(buffer, buffer_size, value, base_offset);
+      group_type<id>::template inject<id, Policy>(aligned_buffer(), buffer_size, value,
+                                                  base_offset);
    }
 
    template<auto id, typename T>
-   void
+   constexpr void
    extract(T& value) const
    {
-      using group_type = typename details::frame::lookup_group<decltype(id), Groups...>::type;
       constexpr std::size_t base_offset{offset<decltype(id)>::value};
-      group_type::template extract<id>(buffer, buffer_size, value, base_offset);
+      group_type<id>::template extract<id, Policy>(aligned_buffer(), buffer_size, value,
+                                                   base_offset);
+   }
+
+   using values_type = typename details::tuple_concat<typename Groups::values_type...>::type;
+
+   using fields_type = typename details::tuple_concat<typename Groups::fields_type...>::type;
+
+   using groups_type = std::tuple<Groups...>;
+
+   constexpr void
+   inject_all(const values_type& values)
+   {
+      static_assert(!std::is_const_v<Byte>, "cannot inject into a read-only frame");
+      Policy::check_access(buffer_size, size);
+      if constexpr(details::is_instrumented<Policy>) {
+         inject_all<Policy>(aligned_buffer(), values, std::index_sequence_for<Groups...>{});
+      }
+      else if constexpr(copy_plan::is_packable) {
+         copy_plan::template inject<size>(aligned_buffer(), values);
+      }
+      else {
+         if(details::is_constant_evaluated()) {
+            inject_all(buffer, values, std::index_sequence_for<Groups...>{});
+            return;
+         }
+         std::array<std::uint8_t, size> staging{};
+         inject_all(staging.data(), values, std::index_sequence_for<Groups...>{});
+         std::memcpy(buffer, staging.data(), size);
+      }
+   }
+
+   constexpr values_type
+   extract_all() const
+   {
+      Policy::check_access(buffer_size, size);
+      values_type values{};
+      if constexpr(details::is_instrumented<Policy>) {
+         extract_all<Policy>(aligned_buffer(), values, std::index_sequence_for<Groups...>{});
+         return values;
+      }
+      if(details::is_constant_evaluated()) {
+         extract_all(buffer, values, std::index_sequence_for<Groups...>{});
+         return values;
+      }
+      std::array<std::uint8_t, size> staging{};
+      std::memcpy(staging.data(), buffer, size);
+      extract_all(staging.data(), values, std::index_sequence_for<Groups...>{});
+      return values;
+   }
+
+   template<auto checksum_id>
+   constexpr void
+   update_checksum()
+   {
+      using algorithm = typename field_type<checksum_id>::algorithm;
+      Policy::check_access(buffer_size, checksum_end<checksum_id>);
+      inject<checksum_id>(details::checksum::compute<algorithm>(
+        buffer + checksum_begin<checksum_id>,
+        checksum_end<checksum_id> - checksum_begin<checksum_id>));
+   }
+
+   template<auto checksum_id>
+   constexpr bool
+   verify_checksum() const
+   {
+      using algorithm = typename field_type<checksum_id>::algorithm;
+      Policy::check_access(buffer_size, checksum_end<checksum_id>);
+      field_value_type<checksum_id> stored{};
+      extract<checksum_id>(stored);
+      return stored == details::checksum::compute<algorithm>(
+                         buffer + checksum_begin<checksum_id>,
+                         checksum_end<checksum_id> - checksum_begin<checksum_id>);
+   }
+
+   template<auto checksum_id, auto id>
+   static constexpr bool
+   covers()
+   {
+      return field_begin<id> >= checksum_begin<checksum_id> &&
+             field_end<id> <= checksum_end<checksum_id>;
+   }
+
+   // Injects a field and patches the listed checksums covering it from the changed bytes alone,
+   // which keeps the cost independent of the frame size.
+   template<auto id, auto... checksum_ids, typename T>
+   void
+   inject_incremental(const T& value)
+   {
+      static_assert((covers<checksum_ids, id>() || ...), "field is not covered by the checksum");
+      static_assert(!(covered_by_any<checksum_ids, checksum_ids...> || ...),
+                    "checksums cannot cover each other");
+      Policy::check_access(buffer_size, field_end<id>);
+
+      std::array<std::uint8_t, field_end<id> - field_begin<id>> delta;
+      std::memcpy(delta.data(), buffer + field_begin<id>, delta.size());
+      inject<id>(value);
+      for(std::size_t i = 0; i < delta.size(); ++i) {
+         delta[i] ^= buffer[field_begin<id> + i];
+      }
+      (patch_checksum<checksum_ids, id>(delta.data()), ...);
+   }
+
+   Span<Byte>
+   payload() const
+   {
+      Policy::check_access(buffer_size, size);
+      return {buffer + size, buffer_size < size ? 0 : buffer_size - size};
+   }
+
+   template<auto length_id>
+   Span<Byte>
+   payload() const
+   {
+      const std::size_t length{payload_length<length_id>()};
+      Policy::check_length(buffer_size, size + length);
+      return {buffer + size, length};
+   }
+
+   template<auto length_id>
+   Span<Byte>
+   resize_payload(std::size_t length)
+   {
+      check_length_range<length_id>(length);
+      Policy::check_length(buffer_size, size + length);
+      inject<length_id>(static_cast<field_value_type<length_id>>(length));
+      return {buffer + size, length};
+   }
+
+   template<auto length_id>
+   Span<Byte>
+   append_payload(const std::uint8_t* data, std::size_t length)
+   {
+      const std::size_t current_length{payload_length<length_id>()};
+      Span<Byte> appended{resize_payload<length_id>(current_length + length)};
+      std::memcpy(appended.data() + current_length, data, length);
+      return appended;
+   }
+
+   template<auto count_id, typename EntryGroup>
+   RepeatedView<Byte, EntryGroup>
+   repeated() const
+   {
+      const std::size_t count{payload_length<count_id>()};
+      Policy::check_length(buffer_size, size + count * EntryGroup::size);
+      return {buffer + size, count};
    }
 
-   std::uint8_t* buffer;
+   template<auto count_id, typename EntryGroup>
+   RepeatedView<Byte, EntryGroup>
+   resize_repeated(std::size_t count)
+   {
+      check_length_range<count_id>(count);
+      Policy::check_length(buffer_size, size + count * EntryGroup::size);
+      inject<count_id>(static_cast<field_value_type<count_id>>(count));
+      return {buffer + size, count};
+   }
+
+   Byte* buffer;
    const std::size_t buffer_size;
+
+ private:
+   // buffer with the guaranteed alignment made known to the compiler, which then turns the field
+   // copies at naturally aligned offsets into aligned loads and stores.
+   constexpr Byte*
+   aligned_buffer() const
+   {
+      if constexpr(alignment > 1) {
+         if(!details::is_constant_evaluated()) {
+            return static_cast<Byte*>(__builtin_assume_aligned(buffer, alignment));
+         }
+      }
+      return buffer;
+   }
+
+   template<auto checksum_id>
+   static constexpr std::size_t checksum_begin{
+     field_type<checksum_id>::range::template begin<BasicFrame, checksum_id>};
+
+   template<auto checksum_id>
+   static constexpr std::size_t checksum_end{[] {
+      constexpr std::size_t range_end{
+        field_type<checksum_id>::range::template end<BasicFrame, checksum_id>};
+      static_assert(checksum_begin<checksum_id> < range_end && range_end <= size);
+      static_assert(range_end <= field_offset<checksum_id> ||
+                      checksum_begin<checksum_id> >=
+                        field_offset<checksum_id> + field_type<checksum_id>::size,
+                    "checksum cannot cover itself");
+      return range_end;
+   }()};
+
+   template<auto id>
+   static constexpr std::size_t field_begin{field_bit_offset<id> / 8};
+
+   template<auto id>
+   static constexpr std::size_t field_end{(field_bit_offset<id> + field_type<id>::bit_size + 7) /
+                                          8};
+
+   template<auto id, auto... checksum_ids>
+   static constexpr bool covered_by_any{(covers<checksum_ids, id>() || ... || false)};
+
+   template<auto checksum_id, auto id>
+   void
+   patch_checksum(const std::uint8_t* delta)
+   {
+      if constexpr(covers<checksum_id, id>()) {
+         using algorithm = typename field_type<checksum_id>::algorithm;
+         constexpr std::size_t trailing_size{checksum_end<checksum_id> - field_end<id>};
+         field_value_type<checksum_id> checksum;
+         extract<checksum_id>(checksum);
+         inject<checksum_id>(details::checksum::patch<algorithm, trailing_size>(
+           checksum, delta, field_end<id> - field_begin<id>));
+      }
+   }
+
+   template<auto length_id>
+   constexpr std::size_t
+   payload_length() const
+   {
+      static_assert(std::is_integral_v<field_value_type<length_id>>);
+      field_value_type<length_id> length{};
+      extract<length_id>(length);
+      return static_cast<std::size_t>(length);
+   }
+
+   // A length the field cannot hold would be stored truncated and describe a shorter payload than
+   // the one written, whatever the bounds policy.
+   template<auto length_id>
+   static void
+   check_length_range(std::size_t length)
+   {
+      static_assert(std::is_integral_v<field_value_type<length_id>>);
+      constexpr auto max{std::numeric_limits<field_value_type<length_id>>::max()};
+      if(length > static_cast<std::uintmax_t>(max)) {
+         throw std::out_of_range{"gbee: length does not fit length field"};
+      }
+   }
+
+   template<std::size_t index>
+   using group_at = details::type_at<index, Groups...>;
+
+   using copy_plan = details::frame::plan<fields_type>;
+
+   static constexpr std::array<std::size_t, sizeof...(Groups)> first_value_index{
+     details::frame::exclusive_prefix_sums<Groups::field_count...>()};
+
+   template<std::size_t group_index, std::size_t... indexes>
+   static constexpr auto
+   values_of(const values_type& values, std::index_sequence<indexes...>)
+   {
+      return std::forward_as_tuple(std::get<first_value_index[group_index] + indexes>(values)...);
+   }
+
+   template<std::size_t group_index, std::size_t... indexes>
+   static constexpr auto
+   values_of(values_type& values, std::index_sequence<indexes...>)
+   {
+      return std::forward_as_tuple(std::get<first_value_index[group_index] + indexes>(values)...);
+   }
+
+   // GroupPolicy is Unchecked once the frame has been checked; an instrumented policy is passed
+   // through so its probe still sees every field.
+   template<typename GroupPolicy = Unchecked, std::size_t... group_indexes>
+   static constexpr void
+   inject_all(std::uint8_t* staging,
+              const values_type& values,
+              std::index_sequence<group_indexes...>)
+   {
+      (group_at<group_indexes>::template inject_all<GroupPolicy>(
+         staging, size,
+         values_of<group_indexes>(
+           values, std::make_index_sequence<group_at<group_indexes>::field_count>{}),
+         offset<typename group_at<group_indexes>::id_type>::value),
+       ...);
+   }
+
+   template<typename GroupPolicy = Unchecked, std::size_t... group_indexes>
+   static constexpr void
+   extract_all(const std::uint8_t* staging,
+               values_type& values,
+               std::index_sequence<group_indexes...>)
+   {
+      (group_at<group_indexes>::template extract_all<GroupPolicy>(
+         staging, size,
+         values_of<group_indexes>(
+           values, std::make_index_sequence<group_at<group_indexes>::field_count>{}),
+         offset<typename group_at<group_indexes>::id_type>::value),
+       ...);
+   }
 };
 
+template<std::size_t extra_size, typename... Groups>
+using Frame = BasicFrame<std::uint8_t, Unchecked, extra_size, Groups...>;
+
+template<std::size_t extra_size, typename... Groups>
+using FrameView = BasicFrame<const std::uint8_t, Unchecked, extra_size, Groups...>;
+
+template<std::size_t alignment, std::size_t extra_size, typename... Groups>
+using AlignedFrame = BasicFrame<std::uint8_t, Aligned<alignment>, extra_size, Groups...>;
+
+template<std::size_t alignment, std::size_t extra_size, typename... Groups>
+using AlignedFrameView = BasicFrame<const std::uint8_t, Aligned<alignment>, extra_size, Groups...>;
+
 } // namespace gbee
@@ -19,6 +19,25 @@
 
 #pragma once
 
+#include <gbee/batch.hpp>
+#include <gbee/bounds.hpp>
+#include <gbee/byte_order.hpp>
+#include <gbee/capture.hpp>
+#include <gbee/checksum.hpp>
+#include <gbee/conditional.hpp>
+#include <gbee/dispatcher.hpp>
+#include <gbee/duplicate.hpp>
 #include <gbee/frame.hpp>
 #include <gbee/group.hpp>
 #include <gbee/helpers.hpp>
+#include <gbee/instrument.hpp>
+#include <gbee/layout.hpp>
+#include <gbee/parallel.hpp>
+#include <gbee/pool.hpp>
+#include <gbee/project.hpp>
+#include <gbee/repeated.hpp>
+#include <gbee/security.hpp>
+#include <gbee/segmented.hpp>
+#include <gbee/span.hpp>
+#include <gbee/stream.hpp>
+#include <gbee/tracked.hpp>
@@ -22,47 +22,136 @@
 #include <array>
 #include <cstddef>
 #include <cstring>
+#include <gbee/bounds.hpp>
+#include <gbee/byte_order.hpp>
 #include <gbee/helpers.hpp>
+#include <tuple>
 #include <type_traits>
+#include <utility>
 
 namespace gbee {
 
 namespace details::packet {
 
-template<auto id, typename Field>
-struct lookup_field_base : public std::enable_if<Field::id == id, Field>
-{};
+template<typename Id>
+struct id_position
+{
+   Id id;
+   std::size_t position;
+
+   friend constexpr bool
+   operator<(const id_position& left, const id_position& right)
+   {
+      return left.id < right.id;
+   }
+};
+
+// Field offsets and bit runs are computed once per group into constexpr arrays. The lookups below
+// take the layout as their single parameter, so instantiating one costs the same regardless of
+// the group size.
+template<typename... Fields>
+struct layout
+{
+   static constexpr std::size_t field_count{sizeof...(Fields)};
+
+   static constexpr std::array<bool, field_count> is_bit_field{Fields::is_bit_field...};
 
-template<auto id, typename... Fields>
-struct lookup_field : public lookup_field_base<id, Fields>...
-{};
+   static constexpr std::array<std::size_t, field_count + 1> bit_offsets{[] {
+      constexpr std::array<std::size_t, field_count> bit_sizes{Fields::bit_size...};
+      std::array<std::size_t, field_count + 1> offsets{};
+      for(std::size_t i = 0; i < field_count; ++i) {
+         offsets[i + 1] = offsets[i] + bit_sizes[i];
+      }
+      return offsets;
+   }()};
 
-template<bool found, auto id, std::size_t current_value, typename...>
-struct offset_helper;
+   using id_type = typename first_type<typename Fields::id_type...>::type;
 
-template<auto id, std::size_t current_value, typename Field, typename... Fields>
-struct offset_helper<true, id, current_value, Field, Fields...>
-  : public offset_helper<true, id, current_value, Fields...>
-{};
+   static constexpr bool has_uniform_ids{
+     (std::is_same_v<id_type, typename Fields::id_type> && ...)};
 
-template<auto id, std::size_t current_value, typename Field, typename... Fields>
-struct offset_helper<false, id, current_value, Field, Fields...>
-  : public offset_helper<Field::id == id,
-                         id,
-                         Field::id == id ? current_value : current_value + Field::size,
-                         Fields...>
-{};
+   // Ids sorted once per group with their positions, so each lookup is a binary search.
+   static constexpr std::array<id_position<id_type>, field_count> sorted_ids{[] {
+      std::array<id_position<id_type>, field_count> ids{};
+      std::size_t position{0};
+      ((ids[position] = {Fields::id, position}, ++position), ...);
+      heap_sort(ids);
+      return ids;
+   }()};
+
+   static constexpr bool has_unique_ids{[] {
+      for(std::size_t i = 1; i < field_count; ++i) {
+         if(sorted_ids[i - 1].id == sorted_ids[i].id) {
+            return false;
+         }
+      }
+      return true;
+   }()};
+
+   static constexpr std::size_t
+   find(id_type id)
+   {
+      std::size_t begin{0};
+      std::size_t end{field_count};
+      while(begin < end) {
+         const std::size_t middle{begin + (end - begin) / 2};
+         if(sorted_ids[middle].id < id) {
+            begin = middle + 1;
+         }
+         else {
+            end = middle;
+         }
+      }
+      return begin < field_count && sorted_ids[begin].id == id ? sorted_ids[begin].position
+                                                              : field_count;
+   }
+
+   template<auto id>
+   static constexpr std::size_t index{find(id)};
+
+   using indexed_fields = indexed_types<std::index_sequence_for<Fields...>, Fields...>;
+
+   // Consecutive bit fields form one run; a byte field is a run of its own.
+   static constexpr std::size_t
+   run_begin(std::size_t index)
+   {
+      while(is_bit_field[index] && index > 0 && is_bit_field[index - 1]) {
+         --index;
+      }
+      return bit_offsets[index];
+   }
+
+   static constexpr std::size_t
+   run_end(std::size_t index)
+   {
+      while(is_bit_field[index] && index + 1 < field_count && is_bit_field[index + 1]) {
+         ++index;
+      }
+      return bit_offsets[index + 1];
+   }
+};
 
-template<bool found, auto id, std::size_t current_value>
-struct offset_helper<found, id, current_value>
+template<auto id, typename Layout>
+struct lookup_field
 {
-   static_assert(found);
-   static constexpr std::size_t value{current_value};
+   static_assert(Layout::template index<id> < Layout::field_count, "no field with this id");
+   using type = indexed_type_at<Layout::template index<id>, typename Layout::indexed_fields>;
 };
 
-template<auto id, typename... Fields>
-struct offset : public offset_helper<false, id, 0, Fields...>
-{};
+template<auto id, typename Layout>
+struct offset
+{
+   static_assert(Layout::template index<id> < Layout::field_count, "no field with this id");
+   static constexpr std::size_t bit_value{Layout::bit_offsets[Layout::template index<id>]};
+   static constexpr std::size_t value{bit_value / 8};
+};
+
+template<auto id, typename Layout>
+struct run
+{
+   static constexpr std::size_t begin{Layout::run_begin(Layout::template index<id>)};
+   static constexpr std::size_t end{Layout::run_end(Layout::template index<id>)};
+};
 
 template<typename Field, typename... Fields>
 struct extract_field_id_type
@@ -72,28 +161,123 @@ struct extract_field_id_type
 
 } // namespace details::packet
 
-template<auto initial_id, typename T>
+template<auto initial_id, typename T, ByteOrder initial_byte_order = ByteOrder::host>
 struct Field
 {
    using id_type = std::decay_t<decltype(initial_id)>;
    using value_type = T;
    static constexpr auto id{initial_id};
    static constexpr std::size_t size{sizeof(value_type)};
+   static constexpr std::size_t bit_size{size * 8};
+   static constexpr bool is_bit_field{false};
+   static constexpr ByteOrder byte_order{initial_byte_order};
+
+   static constexpr void
+   store(std::uint8_t* destination, const value_type& value)
+   {
+      details::byte_order::store<byte_order>(destination, value);
+   }
+
+   static constexpr void
+   load(const std::uint8_t* source, value_type& value)
+   {
+      details::byte_order::load<byte_order>(source, value);
+   }
+};
+
+template<auto id, typename T>
+using LittleEndianField = Field<id, T, ByteOrder::little>;
+
+template<auto id, typename T>
+using BigEndianField = Field<id, T, ByteOrder::big>;
+
+template<auto initial_id,
+         typename T,
+         std::size_t initial_count,
+         ByteOrder initial_byte_order = ByteOrder::host>
+struct ArrayField
+{
+   using id_type = std::decay_t<decltype(initial_id)>;
+   using value_type = std::array<T, initial_count>;
+   using element_type = T;
+   static constexpr auto id{initial_id};
+   static constexpr std::size_t count{initial_count};
+   static constexpr std::size_t size{sizeof(element_type) * count};
+   static constexpr std::size_t bit_size{size * 8};
+   static constexpr bool is_bit_field{false};
+   static constexpr ByteOrder byte_order{initial_byte_order};
+
+   static constexpr void
+   store(std::uint8_t* destination, const value_type& value)
+   {
+      details::byte_order::store_n<byte_order>(destination, value.data(), count);
+   }
+
+   static constexpr void
+   load(const std::uint8_t* source, value_type& value)
+   {
+      details::byte_order::load_n<byte_order>(source, value.data(), count);
+   }
+};
+
+template<auto initial_id, typename T, std::size_t bit_width>
+struct BitField
+{
+   static_assert(std::is_integral_v<T> || std::is_enum_v<T>);
+   static_assert(bit_width > 0 && bit_width <= sizeof(T) * 8);
+
+   using id_type = std::decay_t<decltype(initial_id)>;
+   using value_type = T;
+   static constexpr auto id{initial_id};
+   static constexpr std::size_t bit_size{bit_width};
+   static constexpr bool is_bit_field{true};
+   static constexpr ByteOrder byte_order{ByteOrder::little};
+
+   template<typename Word>
+   static constexpr Word mask{static_cast<Word>(
+     bit_width == 64 ? ~std::uint64_t{0} : (std::uint64_t{1} << bit_width) - 1)};
+
+   template<std::size_t shift, typename Word>
+   static constexpr void
+   store(Word& word, const value_type& value)
+   {
+      static_assert(shift + bit_width <= sizeof(Word) * 8);
+      const Word bits{static_cast<Word>(static_cast<Word>(value) & mask<Word>)};
+      const Word cleared{static_cast<Word>(word & static_cast<Word>(~(mask<Word> << shift)))};
+      word = static_cast<Word>(cleared | (bits << shift));
+   }
+
+   // A signed value is sign-extended from its top bit.
+   template<std::size_t shift, typename Word>
+   static constexpr void
+   load(Word word, value_type& value)
+   {
+      static_assert(shift + bit_width <= sizeof(Word) * 8);
+      std::uint64_t bits{static_cast<std::uint64_t>((word >> shift) & mask<Word>)};
+      if constexpr(std::is_signed_v<value_type> && bit_width < 64) {
+         constexpr std::uint64_t sign{std::uint64_t{1} << (bit_width - 1)};
+         bits = (bits ^ sign) - sign;
+      }
+      value = static_cast<value_type>(bits);
+   }
 };
 
 template<typename... Fields>
 struct Group
 {
-   static_assert(are_values_unique<Fields::id...>);
+   static_assert(details::packet::layout<Fields...>::has_uniform_ids,
+                 "fields of a group have to share one id type");
+   static_assert(details::packet::layout<Fields...>::has_unique_ids);
 
    Group() = delete;
 
    template<auto id>
-   struct lookup_field : public details::packet::lookup_field<id, Fields...>::type
+   struct lookup_field
+     : public details::packet::lookup_field<id, details::packet::layout<Fields...>>::type
    {};
 
    template<auto id>
-   struct offset : public details::packet::offset<id, Fields...>
+   struct offset : public details::packet::offset<id, details::packet::layout<Fields...>>
    {};
 
    template<auto id>
@@ -101,31 +285,162 @@ struct Group
 
    using id_type = typename details::packet::extract_field_id_type<Fields...>::type;
 
-   static constexpr std::size_t size{(lookup_field<Fields::id>::size + ...)};
+   using values_type = std::tuple<typename Fields::value_type...>;
+
+   using fields_type = std::tuple<Fields...>;
 
-   template<id_type id, typename T>
-   static void
+   static constexpr std::size_t field_count{sizeof...(Fields)};
+
+   static constexpr std::size_t bit_size{(Fields::bit_size + ...)};
+   static_assert(bit_size % 8 == 0, "bit fields have to fill whole bytes");
+
+   static constexpr std::size_t size{bit_size / 8};
+
+   template<id_type id, typename Policy = Unchecked, typename T>
+   static constexpr void
    inject(std::uint8_t* buffer,
           std::size_t buffer_size,
           const T& value,
           std::size_t base_offset = 0)
    {
       static_assert(std::is_same_v<T, field_value_type<id>>);
-      const size_t field_offset{base_offset + offset<id>::value};
-      std::memcpy(buffer + field_offset, &value, lookup_field<id>::size);
+      if constexpr(details::is_instrumented<Policy>) {
+         Policy::probe_type::template access<Group, id>(Access::inject, [&] {
+            inject<id, typename Policy::bounds_type>(buffer, buffer_size, value, base_offset);
+         });
+         return;
+      }
+      Policy::check_access(buffer_size, base_offset + access_end<id>);
+      if constexpr(lookup_field<id>::is_bit_field) {
+         using word_type = bit_run_word<id>;
+         const size_t run_offset{base_offset + run<id>::begin / 8};
+         word_type word{};
+         details::byte_order::load_partial<run_size<id>>(buffer + run_offset, word);
+         lookup_field<id>::template store<bit_shift<id>>(word, value);
+         details::byte_order::store_partial<run_size<id>>(buffer + run_offset, word);
+      }
+      else {
+         static_assert(offset<id>::bit_value % 8 == 0, "bit fields have to fill whole bytes");
+         const size_t field_offset{base_offset + offset<id>::value};
+         lookup_field<id>::store(buffer + field_offset, value);
+      }
    }
 
-   template<id_type id, typename T>
-   static void
+   template<id_type id, typename Policy = Unchecked, typename T>
+   static constexpr void
    extract(const std::uint8_t* buffer,
            std::size_t buffer_size,
            T& value,
            std::size_t base_offset = 0)
    {
       static_assert(std::is_same_v<T, field_value_type<id>>);
-      const size_t field_offset{base_offset + offset<id>::value};
-      std::memcpy(&value, buffer + field_offset, lookup_field<id>::size);
+      if constexpr(details::is_instrumented<Policy>) {
+         Policy::probe_type::template access<Group, id>(Access::extract, [&] {
+            extract<id, typename Policy::bounds_type>(buffer, buffer_size, value, base_offset);
+         });
+         return;
+      }
+      Policy::check_access(buffer_size, base_offset + access_end<id>);
+      if constexpr(lookup_field<id>::is_bit_field) {
+         using word_type = bit_run_word<id>;
+         const size_t run_offset{base_offset + run<id>::begin / 8};
+         word_type word{};
+         details::byte_order::load_partial<run_size<id>>(buffer + run_offset, word);
+         lookup_field<id>::template load<bit_shift<id>>(word, value);
+      }
+      else {
+         static_assert(offset<id>::bit_value % 8 == 0, "bit fields have to fill whole bytes");
+         const size_t field_offset{base_offset + offset<id>::value};
+         lookup_field<id>::load(buffer + field_offset, value);
+      }
+   }
+
+   template<typename Policy = Unchecked, typename Values>
+   static constexpr void
+   inject_all(std::uint8_t* buffer,
+              std::size_t buffer_size,
+              const Values& values,
+              std::size_t base_offset = 0)
+   {
+      Policy::check_access(buffer_size, base_offset + size);
+      inject_all<field_policy<Policy>>(buffer, buffer_size, values, base_offset,
+                                       std::index_sequence_for<Fields...>{});
+   }
+
+   template<typename Policy = Unchecked, typename Values>
+   static constexpr void
+   extract_all(const std::uint8_t* buffer,
+               std::size_t buffer_size,
+               Values&& values,
+               std::size_t base_offset = 0)
+   {
+      Policy::check_access(buffer_size, base_offset + size);
+      extract_all<field_policy<Policy>>(buffer, buffer_size, values, base_offset,
+                                        std::index_sequence_for<Fields...>{});
+   }
+
+ private:
+   // The group is checked as a whole; only an instrumented policy still sees every field.
+   template<typename Policy>
+   using field_policy = std::conditional_t<details::is_instrumented<Policy>, Policy, Unchecked>;
+
+   template<typename FieldPolicy, typename Values, std::size_t... indexes>
+   static constexpr void
+   inject_all(std::uint8_t* buffer,
+              std::size_t buffer_size,
+              const Values& values,
+              std::size_t base_offset,
+              std::index_sequence<indexes...>)
+   {
+      (inject<Fields::id, FieldPolicy>(buffer, buffer_size, std::get<indexes>(values),
+                                       base_offset),
+       ...);
+   }
+
+   template<typename FieldPolicy, typename Values, std::size_t... indexes>
+   static constexpr void
+   extract_all(const std::uint8_t* buffer,
+               std::size_t buffer_size,
+               Values& values,
+               std::size_t base_offset,
+               std::index_sequence<indexes...>)
+   {
+      (extract<Fields::id, FieldPolicy>(buffer, buffer_size, std::get<indexes>(values),
+                                        base_offset),
+       ...);
    }
+
+   template<auto id>
+   struct run : public details::packet::run<id, details::packet::layout<Fields...>>
+   {
+      static_assert((run::end - run::begin) % 8 == 0, "bit fields have to fill whole bytes");
+   };
+
+   template<auto id>
+   static constexpr std::size_t run_size{[] {
+      constexpr std::size_t bytes{(run<id>::end - run<id>::begin) / 8};
+      static_assert(bytes <= 8, "a run of bit fields cannot span more than 8 bytes");
+      return bytes;
+   }()};
+
+   // Consecutive bit fields share one little endian word, bit 0 being the LSB of the first byte.
+   // Runs of 3, 5, 6 or 7 bytes use the next wider word, filled from the run bytes alone.
+   template<auto id>
+   using bit_run_word = typename details::byte_order::word<
+     run_size<id> <= 2 ? run_size<id> : run_size<id> <= 4 ? 4 : 8>::type;
+
+   template<auto id>
+   static constexpr std::size_t bit_shift{offset<id>::bit_value - run<id>::begin};
+
+   template<auto id>
+   static constexpr std::size_t access_end{[] {
+      if constexpr(lookup_field<id>::is_bit_field) {
+         return run<id>::end / 8;
+      }
+      else {
+         return offset<id>::value + lookup_field<id>::size;
+      }
+   }()};
 };
 
 } // namespace gbee
@@ -19,49 +19,248 @@
 
 #pragma once
 
+#include <array>
+#include <cstddef>
+#include <string_view>
+#include <tuple>
 #include <type_traits>
+#include <utility>
 
 namespace gbee {
 
 namespace details {
 
-template<auto...>
-struct are_values_unique;
+// Lets constexpr functions swap memcpy and intrinsics for byte-wise code during constant
+// evaluation; available as a builtin in C++17 mode on GCC >= 9 and Clang >= 9.
+constexpr bool
+is_constant_evaluated()
+{
+   return __builtin_is_constant_evaluated();
+}
+
+template<auto value, auto other_value>
+constexpr bool
+is_same_value()
+{
+   if constexpr(std::is_same_v<decltype(value), decltype(other_value)>) {
+      return value == other_value;
+   }
+   else {
+      return false;
+   }
+}
+
+// Values of two arithmetic types compare by value, so 1 and 1u are equal; values of other distinct
+// types, such as ids of two enums, never are.
+template<auto value, auto other_value>
+constexpr bool
+is_equal_value()
+{
+   using value_type = decltype(value);
+   using other_value_type = decltype(other_value);
+   if constexpr(std::is_arithmetic_v<value_type> && std::is_arithmetic_v<other_value_type>) {
+      using common_type = std::common_type_t<value_type, other_value_type>;
+      return static_cast<common_type>(value) == static_cast<common_type>(other_value);
+   }
+   else {
+      return is_same_value<value, other_value>();
+   }
+}
 
-template<>
-struct are_values_unique<>
+template<auto value, auto... values>
+constexpr std::size_t
+value_count()
 {
-   static constexpr bool value{true};
+   return (std::size_t{0} + ... + is_equal_value<value, values>());
+}
+
+template<typename T, typename...>
+struct first_type
+{
+   using type = T;
 };
 
-template<auto element, auto... elements>
-struct are_values_unique<element, elements...>
+// Spelled without std::tuple_element, which is several times slower to instantiate on long packs.
+template<auto value, auto... values>
+inline constexpr bool have_same_value_type{(std::is_same_v<decltype(value), decltype(values)> &&
+                                            ...)};
+
+template<typename T>
+constexpr void
+sift_down(T* array, std::size_t root, std::size_t end)
+{
+   for(std::size_t child{2 * root + 1}; child < end; root = child, child = 2 * root + 1) {
+      if(child + 1 < end && array[child] < array[child + 1]) {
+         ++child;
+      }
+      if(!(array[root] < array[child])) {
+         return;
+      }
+      const T value{array[root]};
+      array[root] = array[child];
+      array[child] = value;
+   }
+}
+
+// std::sort is not constexpr before C++20; heap sort keeps the step count within the constexpr
+// operation limit for groups of thousands of fields.
+template<typename T, std::size_t size>
+constexpr void
+heap_sort(std::array<T, size>& array)
+{
+   T* const data{array.data()};
+   for(std::size_t root{size / 2}; root-- > 0;) {
+      sift_down(data, root, size);
+   }
+   for(std::size_t end{size}; end-- > 1;) {
+      const T value{data[0]};
+      data[0] = data[end];
+      data[end] = value;
+      sift_down(data, 0, end);
+   }
+}
+
+// Values of one type are sorted in a constexpr function, so neither the number of instantiations
+// nor the number of comparisons grows quadratically; ids of mixed types fall back to comparing
+// every pair.
+template<auto... values>
+constexpr bool
+values_unique()
+{
+   if constexpr(sizeof...(values) < 2) {
+      return true;
+   }
+   else if constexpr(have_same_value_type<values...>) {
+      using value_type = typename first_type<decltype(values)...>::type;
+      std::array<value_type, sizeof...(values)> array{values...};
+      heap_sort(array);
+      for(std::size_t i = 1; i < array.size(); ++i) {
+         if(array[i - 1] == array[i]) {
+            return false;
+         }
+      }
+      return true;
+   }
+   else {
+      return ((value_count<values, values...>() == 1) && ...);
+   }
+}
+
+template<typename T, typename... Ts>
+inline constexpr std::size_t type_count{(std::size_t{0} + ... + std::is_same_v<T, Ts>)};
+
+template<typename... Ts>
+inline constexpr bool types_unique{((type_count<Ts, Ts...> == 1) && ...)};
+
+// Position of id among values, or the number of values when absent.
+template<auto id, auto... values>
+constexpr std::size_t
+value_index()
 {
-   static constexpr bool value{((element != elements) && ...) &&
-                               are_values_unique<elements...>::value};
+   if constexpr(have_same_value_type<id, values...>) {
+      const std::array<decltype(id), sizeof...(values)> array{values...};
+      for(std::size_t i = 0; i < array.size(); ++i) {
+         if(array[i] == id) {
+            return i;
+         }
+      }
+      return sizeof...(values);
+   }
+   else {
+      std::size_t index{0};
+      std::size_t found{sizeof...(values)};
+      ((is_same_value<id, values>() ? found = index++ : index++), ...);
+      return found;
+   }
+}
+
+// Position of T among types, or the number of types when absent.
+template<typename T, typename... Ts>
+constexpr std::size_t
+type_index()
+{
+   constexpr std::array<bool, sizeof...(Ts)> matches{{std::is_same_v<T, Ts>...}};
+   for(std::size_t i = 0; i < matches.size(); ++i) {
+      if(matches[i]) {
+         return i;
+      }
+   }
+   return matches.size();
+}
+
+template<std::size_t index, typename T>
+struct indexed_type
+{
+   using type = T;
 };
 
-template<typename...>
-struct are_types_unique;
+template<typename Indexes, typename... Ts>
+struct indexed_types;
+
+template<std::size_t... indexes, typename... Ts>
+struct indexed_types<std::index_sequence<indexes...>, Ts...> : public indexed_type<indexes, Ts>...
+{};
+
+template<std::size_t index, typename T>
+indexed_type<index, T>
+select_indexed_type(const indexed_type<index, T>*);
+
+// Picks a type from an indexed_types by deducing its matching base, which, unlike
+// std::tuple_element, does not instantiate a template per preceding type.
+template<std::size_t index, typename IndexedTypes>
+using indexed_type_at =
+  typename decltype(select_indexed_type<index>(static_cast<const IndexedTypes*>(nullptr)))::type;
+
+template<std::size_t index, typename... Ts>
+using type_at = indexed_type_at<index, indexed_types<std::index_sequence_for<Ts...>, Ts...>>;
 
-template<>
-struct are_types_unique<>
+// Concatenates tuple types without instantiating them, which std::tuple_cat has to do.
+template<typename... Tuples>
+struct tuple_concat
 {
-   static constexpr bool value{true};
+   using type = std::tuple<>;
 };
 
-template<typename T, typename... Ts>
-struct are_types_unique<T, Ts...>
+template<typename... Ts>
+struct tuple_concat<std::tuple<Ts...>>
 {
-   static constexpr bool value{((!std::is_same_v<T, Ts>) &&...) && are_types_unique<Ts...>::value};
+   using type = std::tuple<Ts...>;
 };
 
+template<typename... Ts, typename... Us, typename... Tuples>
+struct tuple_concat<std::tuple<Ts...>, std::tuple<Us...>, Tuples...>
+  : public tuple_concat<std::tuple<Ts..., Us...>, Tuples...>
+{};
+
+// Spells id as the compiler does in a function signature, e.g. "Nwk::Source".
+template<auto id>
+constexpr std::string_view
+value_name()
+{
+   constexpr std::string_view signature{__PRETTY_FUNCTION__};
+   constexpr std::string_view marker{"id = "};
+   constexpr std::size_t begin{signature.find(marker) + marker.size()};
+   constexpr std::size_t end{signature.find_first_of(";]", begin)};
+   return signature.substr(begin, end - begin);
+}
+
+// Index of the field with the given id in a tuple of fields, or the tuple size when absent.
+template<auto id, typename... Fields>
+constexpr std::size_t
+field_index(std::tuple<Fields...>*)
+{
+   return value_index<id, Fields::id...>();
+}
+
 } // namespace details
 
 template<auto... Ts>
-inline constexpr bool are_values_unique{details::are_values_unique<Ts...>::value};
+inline constexpr bool are_values_unique{details::values_unique<Ts...>()};
 
 template<typename... Ts>
-inline constexpr bool are_types_unique{details::are_types_unique<Ts...>::value};
+inline constexpr bool are_types_unique{details::types_unique<Ts...>};
+
+template<auto id>
+inline constexpr std::string_view field_name{details::value_name<id>()};
 
 } // namespace gbee
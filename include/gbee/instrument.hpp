@@ -0,0 +1,205 @@
+//
+// Copyright (C) 2019 Tomasz Jankowski tomasz.jankowski.mail AT gmail.com>
+//
+// This is part of GBee library.
+//
+// GBee is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GBee is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <gbee/bounds.hpp>
+#include <gbee/frame.hpp>
+#include <gbee/helpers.hpp>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#   include <x86intrin.h>
+#endif
+
+namespace gbee {
+
+namespace details::instrument {
+
+// Time stamp counter where available, nanoseconds otherwise.
+inline std::uint64_t
+cycles()
+{
+#if defined(__x86_64__) || defined(__i386__)
+   return __rdtsc();
+#else
+   return static_cast<std::uint64_t>(
+     std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+}
+
+} // namespace details::instrument
+
+struct FieldReport
+{
+   std::string_view name;
+   std::size_t offset;
+   std::size_t bit_offset;
+   std::size_t bit_size;
+   std::uint64_t injects;
+   std::uint64_t extracts;
+   std::uint64_t samples;
+   std::uint64_t cycles;
+};
+
+// Probe counting the injects and extracts of every field, and timing one access out of every
+// sample_period when it is not 0. Counts are kept per group and field, so frames sharing a
+// group also share its counts.
+template<std::uint32_t sample_period = 0>
+class FieldCounters
+{
+ public:
+   template<typename Group, auto id, typename Accessor>
+   static void
+   access(Access access, Accessor&& accessor)
+   {
+      Counters& field{counters<Group, id>};
+      std::atomic<std::uint64_t>& count{access == Access::inject ? field.injects : field.extracts};
+      const std::uint64_t previous{count.fetch_add(1, std::memory_order_relaxed)};
+      if constexpr(sample_period > 0) {
+         if(previous % sample_period == 0) {
+            const std::uint64_t begin{details::instrument::cycles()};
+            accessor();
+            const std::uint64_t end{details::instrument::cycles()};
+            field.samples.fetch_add(1, std::memory_order_relaxed);
+            field.cycles.fetch_add(end - begin, std::memory_order_relaxed);
+            return;
+         }
+      }
+      static_cast<void>(previous);
+      accessor();
+   }
+
+   // Counts of every field of FrameType, in layout order.
+   template<typename FrameType>
+   static std::vector<FieldReport>
+   report()
+   {
+      return report<FrameType>(
+        std::make_index_sequence<std::tuple_size_v<typename FrameType::fields_type>>{});
+   }
+
+   template<typename FrameType>
+   static void
+   reset()
+   {
+      reset<FrameType>(
+        std::make_index_sequence<std::tuple_size_v<typename FrameType::fields_type>>{});
+   }
+
+   // Prints the report of FrameType as a table, one field per line.
+   template<typename FrameType>
+   static void
+   dump(std::FILE* stream)
+   {
+      std::fprintf(stream, "%-32s %8s %8s %12s %12s %12s\n", "field", "offset", "bits", "injects",
+                   "extracts", "cycles");
+      for(const FieldReport& field : report<FrameType>()) {
+         std::fprintf(stream, "%-32.*s %6zu.%zu %8zu %12llu %12llu",
+                      static_cast<int>(field.name.size()), field.name.data(), field.offset,
+                      field.bit_offset % 8, field.bit_size,
+                      static_cast<unsigned long long>(field.injects),
+                      static_cast<unsigned long long>(field.extracts));
+         if(field.samples > 0) {
+            std::fprintf(stream, " %12.1f\n", static_cast<double>(field.cycles) / field.samples);
+         }
+         else {
+            std::fprintf(stream, " %12s\n", "-");
+         }
+      }
+   }
+
+ private:
+   struct Counters
+   {
+      std::atomic<std::uint64_t> injects{0};
+      std::atomic<std::uint64_t> extracts{0};
+      std::atomic<std::uint64_t> samples{0};
+      std::atomic<std::uint64_t> cycles{0};
+   };
+
+   template<typename Group, auto id>
+   static inline Counters counters{};
+
+   template<typename FrameType, std::size_t... indexes>
+   static std::vector<FieldReport>
+   report(std::index_sequence<indexes...>)
+   {
+      std::vector<FieldReport> fields{
+        field_report<FrameType,
+                     std::tuple_element_t<indexes, typename FrameType::fields_type>::id>()...};
+      std::stable_sort(fields.begin(), fields.end(), [](const auto& left, const auto& right) {
+         return left.bit_offset < right.bit_offset;
+      });
+      return fields;
+   }
+
+   template<typename FrameType, auto id>
+   static FieldReport
+   field_report()
+   {
+      const Counters& field{counters<typename FrameType::template group_type<id>, id>};
+      return {field_name<id>,
+              FrameType::template field_offset<id>,
+              FrameType::template field_bit_offset<id>,
+              FrameType::template field_type<id>::bit_size,
+              field.injects.load(std::memory_order_relaxed),
+              field.extracts.load(std::memory_order_relaxed),
+              field.samples.load(std::memory_order_relaxed),
+              field.cycles.load(std::memory_order_relaxed)};
+   }
+
+   template<typename FrameType, std::size_t... indexes>
+   static void
+   reset(std::index_sequence<indexes...>)
+   {
+      (reset_field<FrameType,
+                   std::tuple_element_t<indexes, typename FrameType::fields_type>::id>(),
+       ...);
+   }
+
+   template<typename FrameType, auto id>
+   static void
+   reset_field()
+   {
+      Counters& field{counters<typename FrameType::template group_type<id>, id>};
+      field.injects.store(0, std::memory_order_relaxed);
+      field.extracts.store(0, std::memory_order_relaxed);
+      field.samples.store(0, std::memory_order_relaxed);
+      field.cycles.store(0, std::memory_order_relaxed);
+   }
+};
+
+template<typename Probe, std::size_t extra_size, typename... Groups>
+using InstrumentedFrame = BasicFrame<std::uint8_t, Instrumented<Probe>, extra_size, Groups...>;
+
+template<typename Probe, std::size_t extra_size, typename... Groups>
+using InstrumentedFrameView =
+  BasicFrame<const std::uint8_t, Instrumented<Probe>, extra_size, Groups...>;
+
+} // namespace gbee
@@ -0,0 +1,196 @@
+//
+// Copyright (C) 2019 Tomasz Jankowski tomasz.jankowski.mail AT gmail.com>
+//
+// This is part of GBee library.
+//
+// GBee is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GBee is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <gbee/frame.hpp>
+#include <gbee/group.hpp>
+#include <gbee/helpers.hpp>
+#include <string_view>
+#include <tuple>
+#include <utility>
+
+namespace gbee {
+
+struct FieldLayout
+{
+   std::string_view name;
+   std::size_t offset;
+   std::size_t bit_offset;
+   std::size_t bit_size;
+   std::size_t alignment;
+   bool is_aligned;
+};
+
+namespace details::layout {
+
+// Bit fields are read through the word of their run, so they have no alignment of their own.
+template<typename Field>
+inline constexpr std::size_t natural_alignment{
+  Field::is_bit_field ? 1 : alignof(typename Field::value_type)};
+
+// Alignment known for the address offset bytes past a buffer aligned to buffer_alignment.
+constexpr std::size_t
+known_alignment(std::size_t buffer_alignment, std::size_t offset)
+{
+   const std::size_t lowest_bit{offset & (~offset + 1)};
+   return offset == 0 || lowest_bit > buffer_alignment ? buffer_alignment : lowest_bit;
+}
+
+template<typename FrameType, std::size_t buffer_alignment, typename Field>
+constexpr FieldLayout
+field_layout()
+{
+   constexpr auto id{Field::id};
+   constexpr std::size_t offset{FrameType::template field_offset<id>};
+   constexpr std::size_t alignment{natural_alignment<Field>};
+   return {field_name<id>,
+           offset,
+           FrameType::template field_bit_offset<id>,
+           Field::bit_size,
+           alignment,
+           known_alignment(buffer_alignment, offset) >= alignment};
+}
+
+template<typename FrameType, std::size_t buffer_alignment, std::size_t... indexes>
+constexpr std::array<FieldLayout, sizeof...(indexes)>
+field_layouts(std::index_sequence<indexes...>)
+{
+   return {{field_layout<FrameType,
+                         buffer_alignment,
+                         std::tuple_element_t<indexes, typename FrameType::fields_type>>()...}};
+}
+
+// Stable order of fields by decreasing natural alignment, each run of bit fields moving as one
+// unit of alignment 1. As every size is a multiple of its alignment, each field then starts at
+// a multiple of its own alignment.
+template<typename... Fields>
+constexpr std::array<std::size_t, sizeof...(Fields)>
+aligned_order()
+{
+   constexpr std::size_t count{sizeof...(Fields)};
+   constexpr std::array<bool, count> is_bit_field{Fields::is_bit_field...};
+   constexpr std::array<std::size_t, count> alignments{natural_alignment<Fields>...};
+
+   std::array<std::size_t, count> order{};
+   std::array<std::size_t, count> unit{};
+   for(std::size_t i = 0; i < count; ++i) {
+      order[i] = i;
+      unit[i] = i > 0 && is_bit_field[i] && is_bit_field[i - 1] ? unit[i - 1] : i;
+   }
+   const auto before{[&](std::size_t left, std::size_t right) {
+      return alignments[left] != alignments[right] ? alignments[left] > alignments[right]
+                                                   : unit[left] < unit[right];
+   }};
+   for(std::size_t i = 1; i < count; ++i) {
+      for(std::size_t j = i; j > 0 && before(order[j], order[j - 1]); --j) {
+         const std::size_t moved{order[j]};
+         order[j] = order[j - 1];
+         order[j - 1] = moved;
+      }
+   }
+   return order;
+}
+
+template<typename Group, typename Indexes>
+struct reordered_group;
+
+template<typename... Fields, std::size_t... indexes>
+struct reordered_group<Group<Fields...>, std::index_sequence<indexes...>>
+{
+   static constexpr std::array<std::size_t, sizeof...(Fields)> order{aligned_order<Fields...>()};
+
+   using type = Group<type_at<order[indexes], Fields...>...>;
+};
+
+template<typename Group>
+struct group_alignment;
+
+template<typename... Fields>
+struct group_alignment<Group<Fields...>>
+{
+   static constexpr std::size_t value{std::max({std::size_t{1}, natural_alignment<Fields>...})};
+};
+
+template<typename Indexes, typename... Groups>
+struct reordered_groups;
+
+// Groups by decreasing largest alignment, so that a group is only ever preceded by groups at
+// least as aligned as it.
+template<std::size_t... indexes, typename... Groups>
+struct reordered_groups<std::index_sequence<indexes...>, Groups...>
+{
+   static constexpr std::array<std::size_t, sizeof...(Groups)> order{[] {
+      constexpr std::array<std::size_t, sizeof...(Groups)> alignments{
+        group_alignment<Groups>::value...};
+      std::array<std::size_t, sizeof...(Groups)> positions{indexes...};
+      for(std::size_t i = 1; i < positions.size(); ++i) {
+         for(std::size_t j = i; j > 0 && alignments[positions[j]] > alignments[positions[j - 1]];
+             --j) {
+            const std::size_t moved{positions[j]};
+            positions[j] = positions[j - 1];
+            positions[j - 1] = moved;
+         }
+      }
+      return positions;
+   }()};
+
+   template<std::size_t alignment, std::size_t extra_size>
+   using frame = AlignedFrame<alignment, extra_size, type_at<order[indexes], Groups...>...>;
+};
+
+} // namespace details::layout
+
+// Offset, size and natural alignment of every field of FrameType in layout order, and whether
+// it is aligned in a buffer aligned to buffer_alignment bytes.
+template<typename FrameType, std::size_t buffer_alignment = FrameType::alignment>
+inline constexpr auto field_layouts{details::layout::field_layouts<FrameType, buffer_alignment>(
+  std::make_index_sequence<std::tuple_size_v<typename FrameType::fields_type>>{})};
+
+template<typename FrameType, std::size_t buffer_alignment = FrameType::alignment>
+inline constexpr std::size_t misaligned_field_count{[] {
+   std::size_t count{0};
+   for(const FieldLayout& field : field_layouts<FrameType, buffer_alignment>) {
+      count += field.is_aligned ? 0 : 1;
+   }
+   return count;
+}()};
+
+// The fields of Group by decreasing natural alignment, runs of bit fields kept together, so
+// that none starts off its alignment. In a buffer aligned to a cache line no scalar field then
+// straddles two lines; an array is aligned only to its element and still can. The bytes differ
+// from those of Group: only for frames that never go on the wire, and checksum ranges follow the
+// new order.
+template<typename Group>
+using ReorderedGroup = typename details::layout::reordered_group<
+  Group,
+  std::make_index_sequence<std::tuple_size_v<typename Group::fields_type>>>::type;
+
+// AlignedFrame of the reordered groups, themselves sorted by decreasing alignment. A group whose
+// size is not a multiple of its alignment can still leave the next one misaligned, which
+// misaligned_field_count tells.
+template<std::size_t alignment, std::size_t extra_size, typename... Groups>
+using ReorderedFrame = typename details::layout::reordered_groups<
+  std::index_sequence_for<Groups...>,
+  ReorderedGroup<Groups>...>::template frame<alignment, extra_size>;
+
+} // namespace gbee
@@ -0,0 +1,226 @@
+//
+// Copyright (C) 2019 Tomasz Jankowski tomasz.jankowski.mail AT gmail.com>
+//
+// This is part of GBee library.
+//
+// GBee is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GBee is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace gbee {
+
+// Runs index ranges on a fixed set of threads. Every thread owns a contiguous slice of the
+// indexes and takes them front to back; a thread running dry steals the back half of the
+// busiest looking slice it finds. The calling thread takes part as worker 0.
+class ThreadPool
+{
+ public:
+   explicit ThreadPool(std::size_t thread_count = std::thread::hardware_concurrency())
+     : slices{std::max<std::size_t>(thread_count, 1)}
+   {
+      for(std::size_t worker = 1; worker < slices.size(); ++worker) {
+         threads.emplace_back([this, worker] { wait_for_jobs(worker); });
+      }
+   }
+
+   ThreadPool(const ThreadPool&) = delete;
+
+   ThreadPool&
+   operator=(const ThreadPool&) = delete;
+
+   ~ThreadPool()
+   {
+      {
+         const std::lock_guard<std::mutex> lock{mutex};
+         stopping = true;
+      }
+      job_posted.notify_all();
+      for(std::thread& thread : threads) {
+         thread.join();
+      }
+   }
+
+   std::size_t
+   thread_count() const
+   {
+      return slices.size();
+   }
+
+   // Calls task(index) once for every index in [0, count) and returns when all calls finished.
+   template<typename Task>
+   void
+   parallel_for(std::size_t count, Task&& task)
+   {
+      const std::size_t share{(count + slices.size() - 1) / slices.size()};
+      for(std::size_t worker = 0; worker < slices.size(); ++worker) {
+         slices[worker].begin = std::min(count, worker * share);
+         slices[worker].end = std::min(count, (worker + 1) * share);
+      }
+
+      {
+         const std::lock_guard<std::mutex> lock{mutex};
+         job = {[](void* context, std::size_t index) {
+                   (*static_cast<std::remove_reference_t<Task>*>(context))(index);
+                },
+                const_cast<void*>(static_cast<const void*>(&task))};
+         busy_workers = slices.size();
+         ++generation;
+      }
+      job_posted.notify_all();
+
+      run(0);
+      std::unique_lock<std::mutex> lock{mutex};
+      job_done.wait(lock, [this] { return busy_workers == 0; });
+   }
+
+ private:
+   struct Job
+   {
+      void (*function)(void*, std::size_t);
+      void* context;
+   };
+
+   struct alignas(64) Slice
+   {
+      std::mutex mutex;
+      std::size_t begin{0};
+      std::size_t end{0};
+   };
+
+   void
+   wait_for_jobs(std::size_t worker)
+   {
+      std::uint64_t seen{0};
+      while(true) {
+         {
+            std::unique_lock<std::mutex> lock{mutex};
+            job_posted.wait(lock, [&] { return stopping || generation != seen; });
+            if(stopping) {
+               return;
+            }
+            seen = generation;
+         }
+         run(worker);
+      }
+   }
+
+   void
+   run(std::size_t worker)
+   {
+      const Job current{job};
+      std::size_t index;
+      while(take(worker, index) || (steal(worker) && take(worker, index))) {
+         current.function(current.context, index);
+      }
+
+      const std::lock_guard<std::mutex> lock{mutex};
+      if(--busy_workers == 0) {
+         job_done.notify_all();
+      }
+   }
+
+   bool
+   take(std::size_t worker, std::size_t& index)
+   {
+      Slice& slice{slices[worker]};
+      const std::lock_guard<std::mutex> lock{slice.mutex};
+      if(slice.begin == slice.end) {
+         return false;
+      }
+      index = slice.begin++;
+      return true;
+   }
+
+   bool
+   steal(std::size_t thief)
+   {
+      for(std::size_t offset = 1; offset < slices.size(); ++offset) {
+         Slice& victim{slices[(thief + offset) % slices.size()]};
+         std::size_t begin;
+         std::size_t end;
+         {
+            const std::lock_guard<std::mutex> lock{victim.mutex};
+            if(victim.end - victim.begin < 2) {
+               continue;
+            }
+            begin = victim.begin + (victim.end - victim.begin) / 2;
+            end = victim.end;
+            victim.end = begin;
+         }
+         Slice& own{slices[thief]};
+         const std::lock_guard<std::mutex> lock{own.mutex};
+         own.begin = begin;
+         own.end = end;
+         return true;
+      }
+      return false;
+   }
+
+   std::vector<Slice> slices;
+   std::vector<std::thread> threads;
+   std::mutex mutex;
+   std::condition_variable job_posted;
+   std::condition_variable job_done;
+   Job job{};
+   std::uint64_t generation{0};
+   std::size_t busy_workers{0};
+   bool stopping{false};
+};
+
+namespace details::parallel {
+
+inline constexpr std::size_t cache_line_size{64};
+
+// Smallest frame count whose encoding ends on a cache line boundary, scaled up to about 16 KiB.
+template<std::size_t frame_size>
+inline constexpr std::size_t chunk_frames{[] {
+   const std::size_t aligned{std::lcm(frame_size, cache_line_size) / frame_size};
+   const std::size_t per_chunk{aligned * frame_size};
+   return aligned * std::max<std::size_t>(1, 16384 / per_chunk);
+}()};
+
+} // namespace details::parallel
+
+// Encodes values[i] into output + i * FrameType::size. Work is split on cache line boundaries
+// relative to output, so with a 64-byte aligned output no two threads write the same line.
+template<typename FrameType>
+void
+encode_batch(ThreadPool& pool,
+             const typename FrameType::values_type* values,
+             std::size_t count,
+             std::uint8_t* output)
+{
+   constexpr std::size_t chunk{details::parallel::chunk_frames<FrameType::size>};
+   pool.parallel_for((count + chunk - 1) / chunk, [&](std::size_t chunk_index) {
+      const std::size_t end{std::min(count, (chunk_index + 1) * chunk)};
+      for(std::size_t i = chunk_index * chunk; i < end; ++i) {
+         FrameType{output + i * FrameType::size, FrameType::size}.inject_all(values[i]);
+      }
+   });
+}
+
+} // namespace gbee
@@ -0,0 +1,212 @@
+//
+// Copyright (C) 2019 Tomasz Jankowski tomasz.jankowski.mail AT gmail.com>
+//
+// This is part of GBee library.
+//
+// GBee is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GBee is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <optional>
+
+namespace gbee {
+
+// Fixed capacity pool of frame buffers shared between threads. Slots are carved from one
+// cache line aligned slab and recycled through a lock-free stack whose head carries an ABA tag.
+// Threads that allocate or free often should go through their own FramePool::Cache.
+template<typename FrameType, std::size_t capacity>
+class FramePool
+{
+   static_assert(capacity > 0 && capacity < 0xffffffff);
+
+ public:
+   static constexpr std::size_t cache_line_size{64};
+
+   static constexpr std::size_t slot_size{(FrameType::required_size + cache_line_size - 1) /
+                                          cache_line_size * cache_line_size};
+
+   class Cache;
+
+   FramePool()
+     : slab{static_cast<std::uint8_t*>(
+         ::operator new(slot_size * capacity, std::align_val_t{cache_line_size}))}
+   {
+      for(std::uint32_t index = 0; index < capacity; ++index) {
+         next[index].store(index + 1 < capacity ? index + 1 : empty, std::memory_order_relaxed);
+      }
+      head.store(0, std::memory_order_release);
+   }
+
+   FramePool(const FramePool&) = delete;
+
+   FramePool&
+   operator=(const FramePool&) = delete;
+
+   ~FramePool()
+   {
+      ::operator delete(slab, std::align_val_t{cache_line_size});
+   }
+
+   std::optional<FrameType>
+   acquire()
+   {
+      const std::uint32_t index{pop()};
+      if(index == empty) {
+         return std::nullopt;
+      }
+      return FrameType{slot(index), slot_size};
+   }
+
+   template<typename Frame>
+   void
+   release(const Frame& frame)
+   {
+      const std::uint32_t index{index_of(frame.buffer)};
+      push(index, index);
+   }
+
+   bool
+   owns(const std::uint8_t* buffer) const
+   {
+      return buffer >= slab && buffer < slab + slot_size * capacity;
+   }
+
+ private:
+   static constexpr std::uint32_t empty{0xffffffff};
+
+   std::uint8_t*
+   slot(std::uint32_t index) const
+   {
+      return slab + std::size_t{index} * slot_size;
+   }
+
+   std::uint32_t
+   index_of(const std::uint8_t* buffer) const
+   {
+      return static_cast<std::uint32_t>((buffer - slab) / slot_size);
+   }
+
+   // Pushes the chain first -> ... -> last, already linked through next.
+   void
+   push(std::uint32_t first, std::uint32_t last)
+   {
+      std::uint64_t current{head.load(std::memory_order_relaxed)};
+      std::uint64_t desired;
+      do {
+         next[last].store(static_cast<std::uint32_t>(current), std::memory_order_relaxed);
+         desired = ((current >> 32) + 1) << 32 | first;
+      } while(!head.compare_exchange_weak(current, desired, std::memory_order_release,
+                                          std::memory_order_relaxed));
+   }
+
+   std::uint32_t
+   pop()
+   {
+      std::uint64_t current{head.load(std::memory_order_acquire)};
+      std::uint64_t desired;
+      do {
+         const std::uint32_t index{static_cast<std::uint32_t>(current)};
+         if(index == empty) {
+            return empty;
+         }
+         desired = ((current >> 32) + 1) << 32 | next[index].load(std::memory_order_relaxed);
+      } while(!head.compare_exchange_weak(current, desired, std::memory_order_acquire,
+                                          std::memory_order_acquire));
+      return static_cast<std::uint32_t>(current);
+   }
+
+   std::uint8_t* const slab;
+   std::unique_ptr<std::atomic<std::uint32_t>[]> next{
+     new std::atomic<std::uint32_t>[capacity]};
+   alignas(cache_line_size) std::atomic<std::uint64_t> head{empty};
+};
+
+// Per-thread front end: acquire() and release() stay on a private stack and touch the shared
+// pool only to refill or flush half of it at once.
+template<typename FrameType, std::size_t capacity>
+class FramePool<FrameType, capacity>::Cache
+{
+ public:
+   static constexpr std::size_t cache_size{32};
+
+   explicit Cache(FramePool& initial_pool)
+     : pool{initial_pool}
+   {}
+
+   Cache(const Cache&) = delete;
+
+   Cache&
+   operator=(const Cache&) = delete;
+
+   ~Cache()
+   {
+      flush(count);
+   }
+
+   std::optional<FrameType>
+   acquire()
+   {
+      if(count == 0) {
+         while(count < cache_size / 2) {
+            const std::uint32_t index{pool.pop()};
+            if(index == empty) {
+               break;
+            }
+            indexes[count++] = index;
+         }
+         if(count == 0) {
+            return std::nullopt;
+         }
+      }
+      return FrameType{pool.slot(indexes[--count]), slot_size};
+   }
+
+   template<typename Frame>
+   void
+   release(const Frame& frame)
+   {
+      if(count == cache_size) {
+         flush(cache_size / 2);
+      }
+      indexes[count++] = pool.index_of(frame.buffer);
+   }
+
+ private:
+   void
+   flush(std::size_t flushed)
+   {
+      if(flushed == 0) {
+         return;
+      }
+      const std::size_t first{count - flushed};
+      for(std::size_t i = first; i + 1 < count; ++i) {
+         pool.next[indexes[i]].store(indexes[i + 1], std::memory_order_relaxed);
+      }
+      pool.push(indexes[first], indexes[count - 1]);
+      count = first;
+   }
+
+   FramePool& pool;
+   std::array<std::uint32_t, cache_size> indexes;
+   std::size_t count{0};
+};
+
+} // namespace gbee
@@ -0,0 +1,176 @@
+//
+// Copyright (C) 2019 Tomasz Jankowski tomasz.jankowski.mail AT gmail.com>
+//
+// This is part of GBee library.
+//
+// GBee is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GBee is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <gbee/byte_order.hpp>
+#include <gbee/helpers.hpp>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace gbee {
+
+namespace details::project {
+
+struct Move
+{
+   std::size_t source;
+   std::size_t destination;
+   std::size_t size;
+};
+
+template<typename Field>
+inline constexpr ByteOrder wire_order{Field::byte_order == ByteOrder::host
+                                        ? details::byte_order::native
+                                        : Field::byte_order};
+
+template<typename SourceFrame, typename DestinationFrame>
+struct plan
+{
+   using source_fields = typename SourceFrame::fields_type;
+   using destination_fields = typename DestinationFrame::fields_type;
+
+   static constexpr std::size_t field_count{std::tuple_size_v<destination_fields>};
+
+   template<std::size_t index>
+   using destination_field = std::tuple_element_t<index, destination_fields>;
+
+   template<std::size_t index>
+   static constexpr std::size_t source_index{details::field_index<destination_field<index>::id>(
+     static_cast<source_fields*>(nullptr))};
+
+   template<std::size_t index>
+   static constexpr bool is_matched{source_index<index> < std::tuple_size_v<source_fields>};
+
+   template<std::size_t index>
+   static constexpr bool is_copyable{[] {
+      if constexpr(is_matched<index>) {
+         using destination = destination_field<index>;
+         using source = std::tuple_element_t<source_index<index>, source_fields>;
+         return !source::is_bit_field && !destination::is_bit_field &&
+                std::is_same_v<typename source::value_type, typename destination::value_type> &&
+                wire_order<source> == wire_order<destination>;
+      }
+      else {
+         return false;
+      }
+   }()};
+
+   template<std::size_t index>
+   static constexpr Move move{[] {
+      if constexpr(is_copyable<index>) {
+         constexpr auto id{destination_field<index>::id};
+         return Move{SourceFrame::template field_offset<id>,
+                     DestinationFrame::template field_offset<id>,
+                     destination_field<index>::size};
+      }
+      else {
+         return Move{0, 0, 0};
+      }
+   }()};
+
+   // Byte-identical fields in destination order, merged wherever they follow each other on both
+   // sides.
+   template<std::size_t... indexes>
+   static constexpr auto
+   make_moves(std::index_sequence<indexes...>)
+   {
+      constexpr std::array<Move, sizeof...(indexes)> fields{{move<indexes>...}};
+      std::array<Move, sizeof...(indexes)> merged{};
+      std::size_t count{0};
+      for(const Move& field : fields) {
+         if(field.size == 0) {
+            continue;
+         }
+         if(count > 0 && merged[count - 1].source + merged[count - 1].size == field.source &&
+            merged[count - 1].destination + merged[count - 1].size == field.destination) {
+            merged[count - 1].size += field.size;
+         }
+         else {
+            merged[count++] = field;
+         }
+      }
+      return std::make_pair(merged, count);
+   }
+
+   static constexpr auto merged{make_moves(std::make_index_sequence<field_count>{})};
+
+   static constexpr std::size_t move_count{merged.second};
+
+   static constexpr std::array<Move, field_count> moves{merged.first};
+};
+
+template<typename Plan, typename SourceFrame, typename DestinationFrame, std::size_t... indexes>
+void
+copy_runs(const SourceFrame& source, DestinationFrame& destination, std::index_sequence<indexes...>)
+{
+   (std::memcpy(destination.buffer + Plan::moves[indexes].destination,
+                source.buffer + Plan::moves[indexes].source,
+                Plan::moves[indexes].size),
+    ...);
+}
+
+template<typename Plan, std::size_t index, typename SourceFrame, typename DestinationFrame>
+void
+convert_field(const SourceFrame& source, DestinationFrame& destination)
+{
+   if constexpr(Plan::template is_matched<index> && !Plan::template is_copyable<index>) {
+      constexpr auto id{Plan::template destination_field<index>::id};
+      typename SourceFrame::template field_value_type<id> value;
+      source.template extract<id>(value);
+      destination.template inject<id>(
+        static_cast<typename DestinationFrame::template field_value_type<id>>(value));
+   }
+}
+
+template<typename Plan, typename SourceFrame, typename DestinationFrame, std::size_t... indexes>
+void
+convert_fields(const SourceFrame& source,
+               DestinationFrame& destination,
+               std::index_sequence<indexes...>)
+{
+   (convert_field<Plan, indexes>(source, destination), ...);
+}
+
+} // namespace details::project
+
+// Copies every field of source whose id also exists in destination. Fields laid out the same way
+// on both sides are moved with as few memcpy calls as possible, the remaining ones (bit fields,
+// byte order or type changes) are extracted and injected one by one. Destination fields missing
+// from source are left untouched.
+template<typename SourceFrame, typename DestinationFrame>
+void
+project(const SourceFrame& source, DestinationFrame destination)
+{
+   using plan = details::project::plan<SourceFrame, DestinationFrame>;
+   SourceFrame::policy_type::check_access(source.buffer_size, SourceFrame::size);
+   DestinationFrame::policy_type::check_access(destination.buffer_size, DestinationFrame::size);
+
+   details::project::copy_runs<plan>(source, destination,
+                                     std::make_index_sequence<plan::move_count>{});
+   details::project::convert_fields<plan>(source, destination,
+                                          std::make_index_sequence<plan::field_count>{});
+}
+
+} // namespace gbee
@@ -0,0 +1,99 @@
+//
+// Copyright (C) 2019 Tomasz Jankowski tomasz.jankowski.mail AT gmail.com>
+//
+// This is part of GBee library.
+//
+// GBee is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GBee is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <gbee/byte_order.hpp>
+#include <gbee/group.hpp>
+#include <type_traits>
+
+namespace gbee {
+
+template<typename Byte, typename EntryGroup>
+class RepeatedView
+{
+   static_assert(std::is_same_v<std::remove_const_t<Byte>, std::uint8_t>);
+
+ public:
+   static constexpr std::size_t stride{EntryGroup::size};
+
+   RepeatedView(Byte* initial_buffer, std::size_t initial_count)
+     : buffer{initial_buffer}, count{initial_count}
+   {}
+
+   template<auto id, typename T>
+   void
+   inject(std::size_t index, const T& value) const
+   {
+      static_assert(!std::is_const_v<Byte>, "cannot inject into a read-only frame");
+      EntryGroup::template inject<id>(buffer, stride, value, index * stride);
+   }
+
+   template<auto id, typename T>
+   void
+   extract(std::size_t index, T& value) const
+   {
+      EntryGroup::template extract<id>(buffer, stride, value, index * stride);
+   }
+
+   template<auto id, typename T>
+   void
+   inject_column(const T* values) const
+   {
+      static_assert(!std::is_const_v<Byte>, "cannot inject into a read-only frame");
+      if constexpr(is_contiguous<id, T>) {
+         details::byte_order::store_n<EntryGroup::template lookup_field<id>::byte_order>(
+           buffer, values, count);
+      }
+      else {
+         for(std::size_t i = 0; i < count; ++i) {
+            inject<id>(i, values[i]);
+         }
+      }
+   }
+
+   template<auto id, typename T>
+   void
+   extract_column(T* values) const
+   {
+      if constexpr(is_contiguous<id, T>) {
+         details::byte_order::load_n<EntryGroup::template lookup_field<id>::byte_order>(
+           buffer, values, count);
+      }
+      else {
+         for(std::size_t i = 0; i < count; ++i) {
+            extract<id>(i, values[i]);
+         }
+      }
+   }
+
+   Byte* buffer;
+   const std::size_t count;
+
+ private:
+   template<auto id, typename T>
+   static constexpr bool is_contiguous{
+     EntryGroup::field_count == 1 &&
+     std::is_base_of_v<Field<id, T, EntryGroup::template lookup_field<id>::byte_order>,
+                       typename EntryGroup::template lookup_field<id>>};
+};
+
+} // namespace gbee
@@ -0,0 +1,528 @@
+//
+// Copyright (C) 2019 Tomasz Jankowski tomasz.jankowski.mail AT gmail.com>
+//
+// This is part of GBee library.
+//
+// GBee is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GBee is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <gbee/byte_order.hpp>
+#include <gbee/span.hpp>
+#include <stdexcept>
+
+#if defined(__AES__)
+#   include <wmmintrin.h>
+#endif
+
+namespace gbee {
+
+namespace details::security {
+
+constexpr std::uint8_t
+rotate_left(std::uint8_t value, int shift)
+{
+   return static_cast<std::uint8_t>((value << shift) | (value >> (8 - shift)));
+}
+
+constexpr std::uint8_t
+times_two(std::uint8_t value)
+{
+   return static_cast<std::uint8_t>((value << 1) ^ ((value & 0x80) ? 0x1b : 0x00));
+}
+
+// Walks GF(2^8) with generator 3, so p * q == 1 on every step and q is the inverse of p.
+constexpr std::array<std::uint8_t, 256>
+make_sbox()
+{
+   std::array<std::uint8_t, 256> sbox{};
+   std::uint8_t p{1};
+   std::uint8_t q{1};
+   do {
+      p = static_cast<std::uint8_t>(p ^ times_two(p));
+      q = static_cast<std::uint8_t>(q ^ (q << 1));
+      q = static_cast<std::uint8_t>(q ^ (q << 2));
+      q = static_cast<std::uint8_t>(q ^ (q << 4));
+      if(q & 0x80) {
+         q ^= 0x09;
+      }
+      sbox[p] = static_cast<std::uint8_t>(q ^ rotate_left(q, 1) ^ rotate_left(q, 2) ^
+                                          rotate_left(q, 3) ^ rotate_left(q, 4) ^ 0x63);
+   } while(p != 1);
+   sbox[0] = 0x63;
+   return sbox;
+}
+
+inline constexpr std::array<std::uint8_t, 256> sbox{make_sbox()};
+
+// SubBytes, ShiftRows and MixColumns of one byte as a column word, rotated by 8 bits per table.
+constexpr std::array<std::array<std::uint32_t, 256>, 4>
+make_tables()
+{
+   std::array<std::array<std::uint32_t, 256>, 4> tables{};
+   for(std::size_t i = 0; i < 256; ++i) {
+      const std::uint8_t s{sbox[i]};
+      const std::uint8_t s2{times_two(s)};
+      const std::uint8_t s3{static_cast<std::uint8_t>(s2 ^ s)};
+      const std::uint32_t column{(std::uint32_t{s2} << 24) | (std::uint32_t{s} << 16) |
+                                 (std::uint32_t{s} << 8) | s3};
+      for(std::size_t table = 0; table < tables.size(); ++table) {
+         tables[table][i] = table == 0 ? column : (column >> (8 * table)) |
+                                                    (column << (32 - 8 * table));
+      }
+   }
+   return tables;
+}
+
+inline constexpr std::array<std::array<std::uint32_t, 256>, 4> tables{make_tables()};
+
+inline constexpr std::size_t block_size{16};
+
+using Block = std::array<std::uint8_t, block_size>;
+
+inline void
+xor_into(std::uint8_t* destination, const std::uint8_t* source, std::size_t size)
+{
+   for(std::size_t i = 0; i < size; ++i) {
+      destination[i] ^= source[i];
+   }
+}
+
+} // namespace details::security
+
+// AES-128 with the key schedule expanded once, encrypting independent blocks in place. Rounds of
+// up to four blocks are interleaved with AES-NI, which hides the latency of aesenc.
+class Aes128
+{
+ public:
+   explicit Aes128(const std::array<std::uint8_t, 16>& key)
+   {
+      using details::security::sbox;
+      for(std::size_t i = 0; i < 4; ++i) {
+         details::byte_order::load<ByteOrder::big>(key.data() + 4 * i, words[i]);
+      }
+      std::uint8_t round_constant{1};
+      for(std::size_t i = 4; i < words.size(); ++i) {
+         std::uint32_t word{words[i - 1]};
+         if(i % 4 == 0) {
+            word = (std::uint32_t{sbox[(word >> 16) & 0xff]} << 24) |
+                   (std::uint32_t{sbox[(word >> 8) & 0xff]} << 16) |
+                   (std::uint32_t{sbox[word & 0xff]} << 8) | sbox[word >> 24];
+            word ^= std::uint32_t{round_constant} << 24;
+            round_constant = details::security::times_two(round_constant);
+         }
+         words[i] = words[i - 4] ^ word;
+      }
+      for(std::size_t i = 0; i < words.size(); ++i) {
+         details::byte_order::store<ByteOrder::big>(round_keys.data() + 4 * i, words[i]);
+      }
+   }
+
+   void
+   encrypt(std::uint8_t* blocks, std::size_t count) const
+   {
+      std::size_t i{0};
+#if defined(__AES__)
+      for(; i + 4 <= count; i += 4) {
+         encrypt_interleaved<4>(blocks + i * block_size);
+      }
+      for(; i < count; ++i) {
+         encrypt_interleaved<1>(blocks + i * block_size);
+      }
+#else
+      for(; i < count; ++i) {
+         encrypt_portable(blocks + i * block_size);
+      }
+#endif
+   }
+
+ private:
+   static constexpr std::size_t block_size{details::security::block_size};
+   static constexpr std::size_t rounds{10};
+
+#if defined(__AES__)
+   template<std::size_t count>
+   void
+   encrypt_interleaved(std::uint8_t* blocks) const
+   {
+      __m128i states[count];
+      const __m128i first_key{_mm_load_si128(reinterpret_cast<const __m128i*>(round_keys.data()))};
+      for(std::size_t i = 0; i < count; ++i) {
+         states[i] = _mm_xor_si128(
+           _mm_loadu_si128(reinterpret_cast<const __m128i*>(blocks + i * block_size)), first_key);
+      }
+      for(std::size_t round = 1; round < rounds; ++round) {
+         const __m128i key{_mm_load_si128(
+           reinterpret_cast<const __m128i*>(round_keys.data() + round * block_size))};
+         for(std::size_t i = 0; i < count; ++i) {
+            states[i] = _mm_aesenc_si128(states[i], key);
+         }
+      }
+      const __m128i last_key{_mm_load_si128(
+        reinterpret_cast<const __m128i*>(round_keys.data() + rounds * block_size))};
+      for(std::size_t i = 0; i < count; ++i) {
+         _mm_storeu_si128(reinterpret_cast<__m128i*>(blocks + i * block_size),
+                          _mm_aesenclast_si128(states[i], last_key));
+      }
+   }
+#endif
+
+   void
+   encrypt_portable(std::uint8_t* block) const
+   {
+      using details::security::sbox;
+      constexpr auto& table = details::security::tables;
+      std::array<std::uint32_t, 4> state{};
+      for(std::size_t i = 0; i < state.size(); ++i) {
+         details::byte_order::load<ByteOrder::big>(block + 4 * i, state[i]);
+         state[i] ^= words[i];
+      }
+      for(std::size_t round = 1; round < rounds; ++round) {
+         std::array<std::uint32_t, 4> next{};
+         for(std::size_t i = 0; i < next.size(); ++i) {
+            next[i] = table[0][state[i] >> 24] ^ table[1][(state[(i + 1) % 4] >> 16) & 0xff] ^
+                      table[2][(state[(i + 2) % 4] >> 8) & 0xff] ^
+                      table[3][state[(i + 3) % 4] & 0xff] ^ words[4 * round + i];
+         }
+         state = next;
+      }
+      for(std::size_t i = 0; i < state.size(); ++i) {
+         const std::uint32_t word{(std::uint32_t{sbox[state[i] >> 24]} << 24) |
+                                  (std::uint32_t{sbox[(state[(i + 1) % 4] >> 16) & 0xff]} << 16) |
+                                  (std::uint32_t{sbox[(state[(i + 2) % 4] >> 8) & 0xff]} << 8) |
+                                  sbox[state[(i + 3) % 4] & 0xff]};
+         details::byte_order::store<ByteOrder::big>(block + 4 * i, word ^ words[4 * rounds + i]);
+      }
+   }
+
+   std::array<std::uint32_t, 4 * (rounds + 1)> words{};
+   alignas(16) std::array<std::uint8_t, block_size*(rounds + 1)> round_keys{};
+};
+
+// Fields whose bytes, in the listed order and as stored in the frame, form the CCM* nonce.
+template<auto... ids>
+struct Nonce
+{
+   template<typename FrameType>
+   static constexpr std::size_t size{(0 + ... + FrameType::template field_type<ids>::size)};
+
+   template<typename FrameType>
+   static void
+   copy(const std::uint8_t* buffer, std::uint8_t* nonce)
+   {
+      static_assert(((FrameType::template field_bit_offset<ids> % 8 == 0) && ...),
+                    "nonce fields have to be byte aligned");
+      ((std::memcpy(nonce, buffer + FrameType::template field_offset<ids>,
+                    FrameType::template field_type<ids>::size),
+        nonce += FrameType::template field_type<ids>::size),
+       ...);
+   }
+};
+
+// All groups of the frame, i.e. everything in front of the payload. Ranges of Checksum, such as
+// FieldRange, can be used as well; their second argument is not used.
+struct FixedGroups
+{
+   template<typename FrameType, auto>
+   static constexpr std::size_t begin{0};
+
+   template<typename FrameType, auto>
+   static constexpr std::size_t end{FrameType::size};
+};
+
+// CCM* as used by IEEE 802.15.4 and Zigbee: a 13 byte nonce, a two byte length field, the
+// Header range authenticated and the payload encrypted. A mic_size of 0 only encrypts.
+template<typename NonceFields, std::size_t initial_mic_size = 4, typename Header = FixedGroups>
+struct CcmStar
+{
+   static_assert(initial_mic_size == 0 || initial_mic_size == 4 || initial_mic_size == 8 ||
+                 initial_mic_size == 16);
+
+   using nonce = NonceFields;
+   using header = Header;
+   static constexpr std::size_t mic_size{initial_mic_size};
+};
+
+namespace details::security {
+
+template<typename Stage, typename FrameType>
+struct Ccm
+{
+   static constexpr std::size_t nonce_size{13};
+   static_assert(Stage::nonce::template size<FrameType> == nonce_size);
+
+   static constexpr std::size_t header_begin{Stage::header::template begin<FrameType, 0>};
+   static constexpr std::size_t header_end{Stage::header::template end<FrameType, 0>};
+   static_assert(header_begin <= header_end && header_end <= FrameType::size);
+
+   static constexpr std::size_t header_size{header_end - header_begin};
+   static_assert(header_size < 0xff00, "longer headers need a longer length prefix");
+
+   static constexpr std::size_t mic_size{Stage::mic_size};
+   static constexpr std::size_t max_length{0xffff};
+
+   // Frames sealed or opened together; their CBC-MAC chains advance in one Aes128::encrypt call.
+   static constexpr std::size_t lanes{4};
+
+   static constexpr std::size_t header_blocks{
+     header_size == 0 ? 0 : (2 + header_size + block_size - 1) / block_size};
+
+   struct Job
+   {
+      std::uint8_t* buffer;
+      std::size_t length;
+      std::array<std::uint8_t, nonce_size> nonce;
+   };
+
+   static Job
+   make_job(std::uint8_t* buffer, std::size_t buffer_size, std::size_t length)
+   {
+      if(length > max_length) {
+         throw std::out_of_range{"gbee: CCM* payload longer than 65535 bytes"};
+      }
+      FrameType::policy_type::check_length(buffer_size, FrameType::size + length + mic_size);
+      Job job{buffer, length, {}};
+      Stage::nonce::template copy<FrameType>(buffer, job.nonce.data());
+      return job;
+   }
+
+   static std::size_t
+   mac_blocks(const Job& job)
+   {
+      return 1 + header_blocks + (job.length + block_size - 1) / block_size;
+   }
+
+   // XORs the index-th block of B0 || l(a) || a || padding || m || padding into state.
+   static void
+   absorb(const Job& job, std::size_t index, std::uint8_t* state)
+   {
+      if(index == 0) {
+         constexpr std::uint8_t flags{
+           static_cast<std::uint8_t>((header_size > 0 ? 0x40 : 0x00) |
+                                     (mic_size > 0 ? (mic_size - 2) / 2 : 0) << 3 | 0x01)};
+         state[0] ^= flags;
+         xor_into(state + 1, job.nonce.data(), nonce_size);
+         state[14] ^= static_cast<std::uint8_t>(job.length >> 8);
+         state[15] ^= static_cast<std::uint8_t>(job.length);
+      }
+      else if(index <= header_blocks) {
+         const std::uint8_t* header{job.buffer + header_begin};
+         std::size_t position{(index - 1) * block_size};
+         std::size_t i{0};
+         if(index == 1) {
+            state[0] ^= static_cast<std::uint8_t>(header_size >> 8);
+            state[1] ^= static_cast<std::uint8_t>(header_size);
+            i = 2;
+         }
+         else {
+            position -= 2;
+         }
+         xor_into(state + i, header + position, std::min(block_size - i, header_size - position));
+      }
+      else {
+         const std::size_t position{(index - 1 - header_blocks) * block_size};
+         xor_into(state, job.buffer + FrameType::size + position,
+                  std::min(block_size, job.length - position));
+      }
+   }
+
+   // CBC-MAC tags of up to `lanes` jobs.
+   static void
+   authenticate(const Aes128& key, const Job* jobs, std::size_t count, Block* tags)
+   {
+      std::array<std::size_t, lanes> blocks{};
+      std::size_t most_blocks{0};
+      for(std::size_t lane = 0; lane < count; ++lane) {
+         blocks[lane] = mac_blocks(jobs[lane]);
+         most_blocks = std::max(most_blocks, blocks[lane]);
+      }
+      alignas(16) std::array<Block, lanes> states{};
+      for(std::size_t index = 0; index < most_blocks; ++index) {
+         for(std::size_t lane = 0; lane < count; ++lane) {
+            if(index < blocks[lane]) {
+               absorb(jobs[lane], index, states[lane].data());
+            }
+         }
+         key.encrypt(states[0].data(), count);
+         for(std::size_t lane = 0; lane < count; ++lane) {
+            if(index + 1 == blocks[lane]) {
+               tags[lane] = states[lane];
+            }
+         }
+      }
+   }
+
+   // XORs the key stream S_1, S_2, ... over the payload and returns S_0.
+   static Block
+   apply_key_stream(const Aes128& key, const Job& job, std::uint8_t* data)
+   {
+      constexpr std::size_t chunk{8};
+      alignas(16) std::array<Block, chunk> counters{};
+      for(Block& counter : counters) {
+         counter[0] = 0x01;
+         std::memcpy(counter.data() + 1, job.nonce.data(), nonce_size);
+      }
+
+      Block first{counters[0]};
+      key.encrypt(first.data(), 1);
+
+      for(std::size_t position = 0, counter = 1; position < job.length; counter += chunk) {
+         const std::size_t count{
+           std::min(chunk, (job.length - position + block_size - 1) / block_size)};
+         for(std::size_t i = 0; i < count; ++i) {
+            counters[i][14] = static_cast<std::uint8_t>((counter + i) >> 8);
+            counters[i][15] = static_cast<std::uint8_t>(counter + i);
+         }
+         key.encrypt(counters[0].data(), count);
+         for(std::size_t i = 0; i < count && position < job.length; ++i, position += block_size) {
+            xor_into(data + position, counters[i].data(),
+                     std::min(block_size, job.length - position));
+         }
+      }
+      return first;
+   }
+
+   static void
+   seal(const Aes128& key, Job* jobs, std::size_t count)
+   {
+      std::array<Block, lanes> tags{};
+      if constexpr(mic_size > 0) {
+         authenticate(key, jobs, count, tags.data());
+      }
+      for(std::size_t lane = 0; lane < count; ++lane) {
+         std::uint8_t* payload{jobs[lane].buffer + FrameType::size};
+         const Block first{apply_key_stream(key, jobs[lane], payload)};
+         for(std::size_t i = 0; i < mic_size; ++i) {
+            payload[jobs[lane].length + i] = tags[lane][i] ^ first[i];
+         }
+      }
+   }
+
+   // A frame failing authentication is encrypted again, so it is left as it was received.
+   static void
+   open(const Aes128& key, Job* jobs, std::size_t count, bool* authentic)
+   {
+      std::array<Block, lanes> received{};
+      for(std::size_t lane = 0; lane < count; ++lane) {
+         std::uint8_t* payload{jobs[lane].buffer + FrameType::size};
+         const Block first{apply_key_stream(key, jobs[lane], payload)};
+         for(std::size_t i = 0; i < mic_size; ++i) {
+            received[lane][i] = payload[jobs[lane].length + i] ^ first[i];
+         }
+      }
+      std::array<Block, lanes> tags{};
+      if constexpr(mic_size > 0) {
+         authenticate(key, jobs, count, tags.data());
+      }
+      for(std::size_t lane = 0; lane < count; ++lane) {
+         std::uint8_t difference{0};
+         for(std::size_t i = 0; i < mic_size; ++i) {
+            difference |= static_cast<std::uint8_t>(received[lane][i] ^ tags[lane][i]);
+         }
+         authentic[lane] = difference == 0;
+         if(!authentic[lane]) {
+            apply_key_stream(key, jobs[lane], jobs[lane].buffer + FrameType::size);
+         }
+      }
+   }
+};
+
+} // namespace details::security
+
+// Encrypts the first `length` payload bytes of the frame in place and writes the MIC right after
+// them; returns the secured payload.
+template<typename Stage, typename FrameType>
+Span<std::uint8_t>
+seal(const Aes128& key, FrameType& frame, std::size_t length)
+{
+   using ccm = details::security::Ccm<Stage, FrameType>;
+   typename ccm::Job job{ccm::make_job(frame.buffer, frame.buffer_size, length)};
+   ccm::seal(key, &job, 1);
+   return {frame.buffer + FrameType::size, length + Stage::mic_size};
+}
+
+// Decrypts a secured payload of `length` bytes, MIC included, in place. Returns false and leaves
+// the frame unchanged when the MIC does not match.
+template<typename Stage, typename FrameType>
+bool
+open(const Aes128& key, FrameType& frame, std::size_t length)
+{
+   using ccm = details::security::Ccm<Stage, FrameType>;
+   if(length < Stage::mic_size) {
+      return false;
+   }
+   typename ccm::Job job{ccm::make_job(frame.buffer, frame.buffer_size, length - Stage::mic_size)};
+   bool authentic{false};
+   ccm::open(key, &job, 1, &authentic);
+   return authentic;
+}
+
+template<typename Stage, typename FrameType>
+void
+seal(const Aes128& key, FrameType* frames, const std::size_t* lengths, std::size_t count)
+{
+   using ccm = details::security::Ccm<Stage, FrameType>;
+   std::array<typename ccm::Job, ccm::lanes> jobs;
+   for(std::size_t first = 0; first < count; first += ccm::lanes) {
+      const std::size_t lanes{std::min(ccm::lanes, count - first)};
+      for(std::size_t lane = 0; lane < lanes; ++lane) {
+         FrameType& frame{frames[first + lane]};
+         jobs[lane] = ccm::make_job(frame.buffer, frame.buffer_size, lengths[first + lane]);
+      }
+      ccm::seal(key, jobs.data(), lanes);
+   }
+}
+
+// Returns the number of authentic frames and marks each of them in `authentic`.
+template<typename Stage, typename FrameType>
+std::size_t
+open(const Aes128& key,
+     FrameType* frames,
+     const std::size_t* lengths,
+     std::size_t count,
+     bool* authentic)
+{
+   using ccm = details::security::Ccm<Stage, FrameType>;
+   std::array<typename ccm::Job, ccm::lanes> jobs;
+   std::array<std::size_t, ccm::lanes> indexes{};
+   std::size_t authentic_count{0};
+   for(std::size_t next = 0; next < count;) {
+      std::size_t lanes{0};
+      for(; lanes < ccm::lanes && next < count; ++next) {
+         authentic[next] = false;
+         if(lengths[next] < Stage::mic_size) {
+            continue;
+         }
+         FrameType& frame{frames[next]};
+         indexes[lanes] = next;
+         jobs[lanes++] =
+           ccm::make_job(frame.buffer, frame.buffer_size, lengths[next] - Stage::mic_size);
+      }
+      std::array<bool, ccm::lanes> results{};
+      ccm::open(key, jobs.data(), lanes, results.data());
+      for(std::size_t lane = 0; lane < lanes; ++lane) {
+         authentic[indexes[lane]] = results[lane];
+         authentic_count += results[lane] ? 1 : 0;
+      }
+   }
+   return authentic_count;
+}
+
+} // namespace gbee
@@ -0,0 +1,166 @@
+//
+// Copyright (C) 2019 Tomasz Jankowski tomasz.jankowski.mail AT gmail.com>
+//
+// This is part of GBee library.
+//
+// GBee is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GBee is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <gbee/span.hpp>
+#include <sys/uio.h>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace gbee {
+
+namespace details::segmented {
+
+template<typename Id, typename... Groups>
+constexpr bool
+has_group(std::tuple<Groups...>*)
+{
+   return (std::is_same_v<Id, typename Groups::id_type> || ... || false);
+}
+
+template<typename Id, typename... Segments>
+struct segment_index
+{
+   static constexpr std::array<bool, sizeof...(Segments)> found{
+     {has_group<Id>(static_cast<typename Segments::groups_type*>(nullptr))...}};
+   static_assert((0 + ... + has_group<Id>(static_cast<typename Segments::groups_type*>(nullptr))) ==
+                   1,
+                 "group has to live in exactly one segment");
+
+   static constexpr std::size_t value{[] {
+      std::size_t index{0};
+      while(!found[index]) {
+         ++index;
+      }
+      return index;
+   }()};
+};
+
+} // namespace details::segmented
+
+// A frame whose groups are spread over separately allocated segments, each described by its own
+// Frame type. Segments are written out in order; a Frame with no groups carries a raw payload.
+template<typename... Segments>
+class SegmentedFrame
+{
+ public:
+   static constexpr std::size_t segment_count{sizeof...(Segments)};
+
+   static constexpr std::size_t size{(0 + ... + Segments::size)};
+
+   template<auto id>
+   static constexpr std::size_t segment_index{
+     details::segmented::segment_index<decltype(id), Segments...>::value};
+
+   template<std::size_t index>
+   using segment_type = std::tuple_element_t<index, std::tuple<Segments...>>;
+
+   template<auto id>
+   using field_value_type =
+     typename segment_type<segment_index<id>>::template field_value_type<id>;
+
+   explicit SegmentedFrame(const Segments&... initial_segments)
+     : segments{initial_segments...},
+       lengths{{(Segments::size > 0 ? Segments::size : initial_segments.buffer_size)...}}
+   {}
+
+   template<auto id, typename T>
+   void
+   inject(const T& value)
+   {
+      std::get<segment_index<id>>(segments).template inject<id>(value);
+   }
+
+   template<auto id, typename T>
+   void
+   extract(T& value) const
+   {
+      std::get<segment_index<id>>(segments).template extract<id>(value);
+   }
+
+   template<std::size_t index>
+   segment_type<index>&
+   segment()
+   {
+      return std::get<index>(segments);
+   }
+
+   template<std::size_t index>
+   const segment_type<index>&
+   segment() const
+   {
+      return std::get<index>(segments);
+   }
+
+   std::size_t
+   buffer_size() const
+   {
+      return std::apply([](const auto&... frames) { return (0 + ... + frames.buffer_size); },
+                        segments);
+   }
+
+   // Bytes iovecs() exports: the groups of each header segment and the payload lengths.
+   std::size_t
+   length() const
+   {
+      std::size_t total{0};
+      for(const std::size_t segment_length : lengths) {
+         total += segment_length;
+      }
+      return total;
+   }
+
+   // A payload segment exports its whole buffer until resized to the length actually filled.
+   template<std::size_t index>
+   Span<std::remove_pointer_t<decltype(segment_type<index>::buffer)>>
+   resize_payload(std::size_t length)
+   {
+      static_assert(segment_type<index>::size == 0, "only a payload segment can be resized");
+      segment_type<index>& frame{std::get<index>(segments)};
+      segment_type<index>::policy_type::check_length(frame.buffer_size, length);
+      lengths[index] = length;
+      return {frame.buffer, length};
+   }
+
+   // Ready for writev()/sendmsg(), in segment order.
+   std::array<iovec, segment_count>
+   iovecs() const
+   {
+      return iovecs(std::index_sequence_for<Segments...>{});
+   }
+
+ private:
+   template<std::size_t... indexes>
+   std::array<iovec, segment_count>
+   iovecs(std::index_sequence<indexes...>) const
+   {
+      return {{iovec{const_cast<std::uint8_t*>(std::get<indexes>(segments).buffer),
+                     lengths[indexes]}...}};
+   }
+
+   std::tuple<Segments...> segments;
+   std::array<std::size_t, segment_count> lengths;
+};
+
+} // namespace gbee
@@ -0,0 +1,87 @@
+//
+// Copyright (C) 2019 Tomasz Jankowski tomasz.jankowski.mail AT gmail.com>
+//
+// This is part of GBee library.
+//
+// GBee is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GBee is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+
+namespace gbee {
+
+template<typename T>
+class Span
+{
+ public:
+   using element_type = T;
+   using value_type = std::remove_cv_t<T>;
+   using iterator = T*;
+
+   constexpr Span() = default;
+
+   constexpr Span(T* initial_data, std::size_t initial_size)
+     : data_{initial_data}, size_{initial_size}
+   {}
+
+   template<typename U, typename = std::enable_if_t<std::is_convertible_v<U*, T*>>>
+   constexpr Span(const Span<U>& other)
+     : data_{other.data()}, size_{other.size()}
+   {}
+
+   constexpr T*
+   data() const
+   {
+      return data_;
+   }
+
+   constexpr std::size_t
+   size() const
+   {
+      return size_;
+   }
+
+   constexpr bool
+   empty() const
+   {
+      return size_ == 0;
+   }
+
+   constexpr T*
+   begin() const
+   {
+      return data_;
+   }
+
+   constexpr T*
+   end() const
+   {
+      return data_ + size_;
+   }
+
+   constexpr T&
+   operator[](std::size_t index) const
+   {
+      return data_[index];
+   }
+
+ private:
+   T* data_{nullptr};
+   std::size_t size_{0};
+};
+
+} // namespace gbee
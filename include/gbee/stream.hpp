@@ -0,0 +1,148 @@
+//
+// Copyright (C) 2019 Tomasz Jankowski tomasz.jankowski.mail AT gmail.com>
+//
+// This is part of GBee library.
+//
+// GBee is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GBee is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace gbee {
+
+// Single producer, single consumer byte ring that delimits frames with a payload length field.
+// write() may run in an interrupt handler or another thread than read(). Complete frames are
+// handed out in place; only frames crossing the wrap point are copied into a scratch buffer.
+template<typename FrameType, auto length_id, std::size_t capacity>
+class StreamParser
+{
+   static_assert(capacity > 0 && (capacity & (capacity - 1)) == 0,
+                 "capacity has to be a power of two");
+   static_assert(capacity >= FrameType::size);
+   static_assert(std::is_constructible_v<FrameType, const std::uint8_t*, std::size_t>,
+                 "frame type cannot be built over a read-only buffer");
+   static_assert(std::is_integral_v<typename FrameType::template field_value_type<length_id>>);
+
+   using header_group = typename FrameType::template group_type<length_id>;
+
+ public:
+   static constexpr std::size_t max_frame_size{capacity};
+
+   std::size_t
+   write(const std::uint8_t* data, std::size_t size)
+   {
+      const std::size_t write_index{head.load(std::memory_order_relaxed)};
+      const std::size_t read_index{tail.load(std::memory_order_acquire)};
+      size = std::min(size, capacity - (write_index - read_index));
+
+      const std::size_t offset{write_index & mask};
+      if(offset + size <= capacity) {
+         std::memcpy(ring.data() + offset, data, size);
+      }
+      else {
+         const std::size_t first{capacity - offset};
+         std::memcpy(ring.data() + offset, data, first);
+         std::memcpy(ring.data(), data + first, size - first);
+      }
+      head.store(write_index + size, std::memory_order_release);
+      return size;
+   }
+
+   // Calls handler(FrameType) for every complete frame and returns their count. The frame is
+   // only valid during the call, its bytes are released right after it.
+   template<typename Handler>
+   std::size_t
+   read(Handler&& handler)
+   {
+      std::size_t read_index{tail.load(std::memory_order_relaxed)};
+      const std::size_t write_index{head.load(std::memory_order_acquire)};
+      std::size_t frames{0};
+
+      while(write_index - read_index >= FrameType::size) {
+         const std::size_t length{payload_length(contiguous(read_index, FrameType::size))};
+         if(length > max_frame_size - FrameType::size) {
+            ++read_index;
+            ++dropped_bytes;
+            tail.store(read_index, std::memory_order_release);
+            continue;
+         }
+
+         const std::size_t frame_size{FrameType::size + length};
+         if(write_index - read_index < frame_size) {
+            break;
+         }
+
+         handler(FrameType{contiguous(read_index, frame_size), frame_size});
+         read_index += frame_size;
+         ++frames;
+         tail.store(read_index, std::memory_order_release);
+      }
+      return frames;
+   }
+
+   std::size_t
+   available() const
+   {
+      return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+   }
+
+   // Bytes skipped to resynchronise after a length field that could never fit the ring.
+   std::size_t
+   dropped() const
+   {
+      return dropped_bytes;
+   }
+
+ private:
+   static constexpr std::size_t mask{capacity - 1};
+
+   const std::uint8_t*
+   contiguous(std::size_t index, std::size_t size)
+   {
+      const std::size_t offset{index & mask};
+      if(offset + size <= capacity) {
+         return ring.data() + offset;
+      }
+      const std::size_t first{capacity - offset};
+      std::memcpy(scratch.data(), ring.data() + offset, first);
+      std::memcpy(scratch.data() + first, ring.data(), size - first);
+      return scratch.data();
+   }
+
+   static std::size_t
+   payload_length(const std::uint8_t* header)
+   {
+      constexpr std::size_t group_offset{FrameType::template field_offset<length_id> -
+                                         header_group::template offset<length_id>::value};
+      typename FrameType::template field_value_type<length_id> length;
+      header_group::template extract<length_id>(header, FrameType::size, length, group_offset);
+      return static_cast<std::size_t>(length);
+   }
+
+   alignas(64) std::array<std::uint8_t, capacity> ring;
+   std::array<std::uint8_t, capacity> scratch;
+   alignas(64) std::atomic<std::size_t> head{0};
+   alignas(64) std::atomic<std::size_t> tail{0};
+   std::size_t dropped_bytes{0};
+};
+
+} // namespace gbee
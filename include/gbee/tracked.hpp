@@ -0,0 +1,129 @@
+//
+// Copyright (C) 2019 Tomasz Jankowski tomasz.jankowski.mail AT gmail.com>
+//
+// This is part of GBee library.
+//
+// GBee is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GBee is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#pragma once
+
+#include <bitset>
+#include <cstddef>
+#include <gbee/helpers.hpp>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace gbee {
+
+// Stages field values in front of a frame and writes back only the changed ones on commit(),
+// patching the listed checksums from the changed bytes instead of re-hashing their ranges.
+template<typename FrameType, auto... checksum_ids>
+class TrackedFrame
+{
+ public:
+   using fields_type = typename FrameType::fields_type;
+
+   using values_type = typename FrameType::values_type;
+
+   static constexpr std::size_t field_count{std::tuple_size_v<fields_type>};
+
+   template<auto id>
+   static constexpr std::size_t field_index{
+     details::field_index<id>(static_cast<fields_type*>(nullptr))};
+
+   explicit TrackedFrame(const FrameType& initial_frame)
+     : frame{initial_frame}
+   {}
+
+   template<auto id, typename T>
+   void
+   inject(const T& value)
+   {
+      static_assert(std::is_same_v<T, typename FrameType::template field_value_type<id>>);
+      std::get<field_index<id>>(staged) = value;
+      dirty.set(field_index<id>);
+   }
+
+   template<auto id, typename T>
+   void
+   extract(T& value) const
+   {
+      if(dirty.test(field_index<id>)) {
+         value = std::get<field_index<id>>(staged);
+      }
+      else {
+         frame.template extract<id>(value);
+      }
+   }
+
+   template<auto id>
+   bool
+   is_dirty() const
+   {
+      return dirty.test(field_index<id>);
+   }
+
+   bool
+   is_dirty() const
+   {
+      return dirty.any();
+   }
+
+   void
+   commit()
+   {
+      if(dirty.any()) {
+         commit(std::make_index_sequence<field_count>{});
+         dirty.reset();
+      }
+   }
+
+   void
+   discard()
+   {
+      dirty.reset();
+   }
+
+   FrameType frame;
+
+ private:
+   template<std::size_t... indexes>
+   void
+   commit(std::index_sequence<indexes...>)
+   {
+      (commit_field<std::tuple_element_t<indexes, fields_type>::id>(), ...);
+   }
+
+   template<auto id>
+   void
+   commit_field()
+   {
+      if(!dirty.test(field_index<id>)) {
+         return;
+      }
+      if constexpr((FrameType::template covers<checksum_ids, id>() || ... || false)) {
+         frame.template inject_incremental<id, checksum_ids...>(std::get<field_index<id>>(staged));
+      }
+      else {
+         frame.template inject<id>(std::get<field_index<id>>(staged));
+      }
+   }
+
+   values_type staged;
+   std::bitset<field_count> dirty;
+};
+
+} // namespace gbee
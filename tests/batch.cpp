@@ -0,0 +1,110 @@
+//
+// Copyright (C) 2019 Tomasz Jankowski tomasz.jankowski.mail AT gmail.com>
+//
+// This is part of GBee library.
+//
+// GBee is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GBee is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#include <cstdint>
+#include <gbee/gbee.hpp>
+#include <gtest/gtest.h>
+#include <vector>
+
+enum class Record
+{
+   Flags,
+   Kind,
+   Sequence,
+   Source,
+   Counter,
+   Extended,
+   Timestamp
+};
+
+using namespace gbee;
+
+using RecordGroup = Group<BitField<Record::Flags, std::uint8_t, 4>,
+                          BitField<Record::Kind, std::uint8_t, 4>,
+                          Field<Record::Sequence, std::uint8_t>,
+                          BigEndianField<Record::Source, std::uint16_t>,
+                          LittleEndianField<Record::Counter, std::uint32_t>,
+                          BigEndianField<Record::Extended, std::uint64_t>,
+                          Field<Record::Timestamp, std::uint32_t>>;
+
+using RecordFrame = Frame<0, RecordGroup>;
+
+class Batch : public ::testing::Test
+{
+ protected:
+   void
+   SetUp() override
+   {
+      records.resize(count * RecordFrame::size);
+      for(std::size_t i = 0; i < count; ++i) {
+         RecordFrame frame{records.data() + i * RecordFrame::size, RecordFrame::size};
+         frame.inject_all({static_cast<std::uint8_t>(i % 16), static_cast<std::uint8_t>(i % 7),
+                           static_cast<std::uint8_t>(i), static_cast<std::uint16_t>(0x1000 + i),
+                           static_cast<std::uint32_t>(0x20000000 + i * 3),
+                           0x3000000000000000 + i * 5, static_cast<std::uint32_t>(i * 11)});
+      }
+   }
+
+   template<auto id>
+   void
+   expect_column()
+   {
+      using value_type = RecordFrame::field_value_type<id>;
+      std::vector<value_type> column(count);
+      extract_column<RecordFrame, id>(records.data(), count, column.data());
+
+      for(std::size_t i = 0; i < count; ++i) {
+         const FrameView<0, RecordGroup> view{records.data() + i * RecordFrame::size,
+                                              RecordFrame::size};
+         value_type expected;
+         view.extract<id>(expected);
+         EXPECT_EQ(column[i], expected) << "record " << i;
+      }
+   }
+
+   static constexpr std::size_t count{37};
+   std::vector<std::uint8_t> records;
+};
+
+TEST_F(Batch, extract_column)
+{
+   expect_column<Record::Flags>();
+   expect_column<Record::Kind>();
+   expect_column<Record::Sequence>();
+   expect_column<Record::Source>();
+   expect_column<Record::Counter>();
+   expect_column<Record::Extended>();
+   expect_column<Record::Timestamp>();
+}
+
+TEST_F(Batch, extract_column_with_stride)
+{
+   constexpr std::size_t stride{RecordFrame::size + 3};
+   std::vector<std::uint8_t> padded(count * stride);
+   for(std::size_t i = 0; i < count; ++i) {
+      std::copy_n(records.data() + i * RecordFrame::size, RecordFrame::size,
+                  padded.data() + i * stride);
+   }
+
+   std::vector<std::uint16_t> sources(count);
+   extract_column<RecordFrame, Record::Source>(padded.data(), count, sources.data(), stride);
+   for(std::size_t i = 0; i < count; ++i) {
+      EXPECT_EQ(sources[i], 0x1000 + i);
+   }
+}
@@ -0,0 +1,87 @@
+//
+// Copyright (C) 2019 Tomasz Jankowski tomasz.jankowski.mail AT gmail.com>
+//
+// This is part of GBee library.
+//
+// GBee is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GBee is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#include <cstdint>
+#include <gbee/gbee.hpp>
+#include <gtest/gtest.h>
+#include <stdexcept>
+
+enum class Bounds
+{
+   A,
+   B
+};
+
+using namespace gbee;
+
+using BoundsGroup = Group<Field<Bounds::A, std::uint16_t>, Field<Bounds::B, std::uint32_t>>;
+
+template<typename Policy>
+using BoundsFrame = BasicFrame<std::uint8_t, Policy, 2, BoundsGroup>;
+
+TEST(Bounds, unchecked)
+{
+   std::array<std::uint8_t, 4> buffer{{0}};
+   EXPECT_NO_THROW(BoundsFrame<Unchecked>{buffer});
+
+   const std::uint16_t a_value{0x1111};
+   BoundsGroup::inject<Bounds::A, Unchecked>(buffer.data(), buffer.size(), a_value);
+   EXPECT_EQ(buffer[1], 0x11);
+}
+
+TEST(Bounds, check_once)
+{
+   std::array<std::uint8_t, 7> short_buffer{{0}};
+   EXPECT_THROW(BoundsFrame<CheckOnce>{short_buffer}, std::out_of_range);
+
+   std::array<std::uint8_t, 8> buffer{{0}};
+   BoundsFrame<CheckOnce> frame{buffer};
+
+   const std::uint32_t b_value{0x22222222};
+   EXPECT_NO_THROW(frame.inject<Bounds::B>(b_value));
+
+   std::uint32_t extracted{0};
+   frame.extract<Bounds::B>(extracted);
+   EXPECT_EQ(extracted, b_value);
+}
+
+TEST(Bounds, check_each_access)
+{
+   std::array<std::uint8_t, 4> buffer{{0}};
+   BoundsFrame<CheckEachAccess> frame{buffer};
+
+   const std::uint16_t a_value{0x1111};
+   EXPECT_NO_THROW(frame.inject<Bounds::A>(a_value));
+
+   const std::uint32_t b_value{0x22222222};
+   EXPECT_THROW(frame.inject<Bounds::B>(b_value), std::out_of_range);
+   EXPECT_THROW(frame.extract_all(), std::out_of_range);
+
+   std::uint32_t extracted{0};
+   EXPECT_THROW(
+     (BoundsGroup::extract<Bounds::B, CheckEachAccess>(buffer.data(), buffer.size(), extracted)),
+     std::out_of_range);
+
+   std::uint16_t a_extracted{0};
+   EXPECT_NO_THROW((BoundsGroup::extract<Bounds::A, CheckEachAccess>(buffer.data(), buffer.size(),
+                                                                     a_extracted, 2)));
+   EXPECT_THROW((BoundsGroup::extract<Bounds::A, CheckEachAccess>(buffer.data(), buffer.size(),
+                                                                  a_extracted, 3)),
+                std::out_of_range);
+}
@@ -0,0 +1,192 @@
+//
+// Copyright (C) 2019 Tomasz Jankowski tomasz.jankowski.mail AT gmail.com>
+//
+// This is part of GBee library.
+//
+// GBee is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GBee is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#include <cstdint>
+#include <gbee/gbee.hpp>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <type_traits>
+
+enum class Order
+{
+   A,
+   B,
+   C,
+   D
+};
+
+enum class Command : std::uint16_t
+{
+   Ping = 0x0102
+};
+
+using namespace gbee;
+
+using LittleGroup = Group<LittleEndianField<Order::A, std::uint16_t>,
+                          LittleEndianField<Order::B, std::uint32_t>,
+                          LittleEndianField<Order::C, std::uint64_t>,
+                          LittleEndianField<Order::D, Command>>;
+
+using BigGroup = Group<BigEndianField<Order::A, std::uint16_t>,
+                       BigEndianField<Order::B, std::uint32_t>,
+                       BigEndianField<Order::C, std::uint64_t>,
+                       BigEndianField<Order::D, Command>>;
+
+TEST(ByteOrder, validate)
+{
+   using Bar = Field<Order::A, std::uint16_t>;
+   EXPECT_EQ(Bar::byte_order, ByteOrder::host);
+   EXPECT_EQ(LittleGroup::lookup_field<Order::A>::byte_order, ByteOrder::little);
+   EXPECT_EQ(BigGroup::lookup_field<Order::A>::byte_order, ByteOrder::big);
+   EXPECT_EQ(LittleGroup::size, BigGroup::size);
+}
+
+TEST(ByteOrder, little_endian)
+{
+   std::array<std::uint8_t, 16> buffer{{0}};
+   static_assert(buffer.size() == LittleGroup::size);
+
+   LittleGroup::inject<Order::A>(buffer.data(), buffer.size(), std::uint16_t{0x0102});
+   LittleGroup::inject<Order::B>(buffer.data(), buffer.size(), std::uint32_t{0x03040506});
+   LittleGroup::inject<Order::C>(buffer.data(), buffer.size(), std::uint64_t{0x0708090a0b0c0d0e});
+   LittleGroup::inject<Order::D>(buffer.data(), buffer.size(), Command::Ping);
+   EXPECT_THAT(buffer, ::testing::ElementsAre(0x02, 0x01, 0x06, 0x05, 0x04, 0x03, 0x0e, 0x0d, 0x0c,
+                                              0x0b, 0x0a, 0x09, 0x08, 0x07, 0x02, 0x01));
+
+   std::uint16_t a_value{0};
+   LittleGroup::extract<Order::A>(buffer.data(), buffer.size(), a_value);
+   EXPECT_EQ(a_value, 0x0102);
+
+   std::uint32_t b_value{0};
+   LittleGroup::extract<Order::B>(buffer.data(), buffer.size(), b_value);
+   EXPECT_EQ(b_value, 0x03040506);
+
+   std::uint64_t c_value{0};
+   LittleGroup::extract<Order::C>(buffer.data(), buffer.size(), c_value);
+   EXPECT_EQ(c_value, 0x0708090a0b0c0d0e);
+
+   Command d_value{};
+   LittleGroup::extract<Order::D>(buffer.data(), buffer.size(), d_value);
+   EXPECT_EQ(d_value, Command::Ping);
+}
+
+TEST(ByteOrder, big_endian)
+{
+   std::array<std::uint8_t, 16> buffer{{0}};
+   static_assert(buffer.size() == BigGroup::size);
+
+   BigGroup::inject<Order::A>(buffer.data(), buffer.size(), std::uint16_t{0x0102});
+   BigGroup::inject<Order::B>(buffer.data(), buffer.size(), std::uint32_t{0x03040506});
+   BigGroup::inject<Order::C>(buffer.data(), buffer.size(), std::uint64_t{0x0708090a0b0c0d0e});
+   BigGroup::inject<Order::D>(buffer.data(), buffer.size(), Command::Ping);
+   EXPECT_THAT(buffer, ::testing::ElementsAre(0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09,
+                                              0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x01, 0x02));
+
+   std::uint16_t a_value{0};
+   BigGroup::extract<Order::A>(buffer.data(), buffer.size(), a_value);
+   EXPECT_EQ(a_value, 0x0102);
+
+   std::uint32_t b_value{0};
+   BigGroup::extract<Order::B>(buffer.data(), buffer.size(), b_value);
+   EXPECT_EQ(b_value, 0x03040506);
+
+   std::uint64_t c_value{0};
+   BigGroup::extract<Order::C>(buffer.data(), buffer.size(), c_value);
+   EXPECT_EQ(c_value, 0x0708090a0b0c0d0e);
+
+   Command d_value{};
+   BigGroup::extract<Order::D>(buffer.data(), buffer.size(), d_value);
+   EXPECT_EQ(d_value, Command::Ping);
+}
+
+TEST(ByteOrder, floating_point)
+{
+   using FloatGroup = Group<BigEndianField<Order::A, float>, BigEndianField<Order::B, double>>;
+
+   std::array<std::uint8_t, 12> buffer{{0}};
+   FloatGroup::inject<Order::A>(buffer.data(), buffer.size(), 1.0f);
+   FloatGroup::inject<Order::B>(buffer.data(), buffer.size(), -2.0);
+   EXPECT_THAT(buffer, ::testing::ElementsAre(0x3f, 0x80, 0x00, 0x00, 0xc0, 0x00, 0x00, 0x00, 0x00,
+                                              0x00, 0x00, 0x00));
+
+   float a_value{0};
+   FloatGroup::extract<Order::A>(buffer.data(), buffer.size(), a_value);
+   EXPECT_EQ(a_value, 1.0f);
+
+   double b_value{0};
+   FloatGroup::extract<Order::B>(buffer.data(), buffer.size(), b_value);
+   EXPECT_EQ(b_value, -2.0);
+}
+
+TEST(ByteOrder, bulk_conversion)
+{
+   std::array<std::uint32_t, 37> values{};
+   for(std::size_t i = 0; i < values.size(); ++i) {
+      values[i] = static_cast<std::uint32_t>(0x01020304 * (i + 1));
+   }
+
+   std::array<std::uint8_t, values.size() * 4> buffer{};
+   details::byte_order::store_n<ByteOrder::big>(buffer.data(), values.data(), values.size());
+   for(std::size_t i = 0; i < values.size(); ++i) {
+      EXPECT_EQ(buffer[i * 4], static_cast<std::uint8_t>(values[i] >> 24));
+      EXPECT_EQ(buffer[i * 4 + 3], static_cast<std::uint8_t>(values[i]));
+   }
+
+   std::array<std::uint32_t, 37> extracted{};
+   details::byte_order::load_n<ByteOrder::big>(buffer.data(), extracted.data(), extracted.size());
+   EXPECT_EQ(extracted, values);
+
+   std::array<std::uint16_t, 19> short_values{};
+   for(std::size_t i = 0; i < short_values.size(); ++i) {
+      short_values[i] = static_cast<std::uint16_t>(0x0102 * (i + 1));
+   }
+   std::array<std::uint16_t, 19> swapped{};
+   details::byte_order::store_n<ByteOrder::big>(reinterpret_cast<std::uint8_t*>(swapped.data()),
+                                               short_values.data(), short_values.size());
+   for(std::size_t i = 0; i < short_values.size(); ++i) {
+      EXPECT_EQ(swapped[i], details::byte_order::swap(short_values[i]));
+   }
+}
+
+TEST(ByteOrder, constant_evaluation)
+{
+   constexpr auto big{[] {
+      std::array<std::uint8_t, 12> buffer{};
+      details::byte_order::store<ByteOrder::big>(buffer.data(), std::uint32_t{0x01020304});
+      details::byte_order::store<ByteOrder::little>(buffer.data() + 4, -2.0f);
+      details::byte_order::store<ByteOrder::big>(buffer.data() + 8, Command::Ping);
+      return buffer;
+   }()};
+   static_assert(big[0] == 0x01 && big[3] == 0x04);
+   static_assert(big[7] == 0xc0 && big[4] == 0x00);
+   static_assert(big[8] == 0x01 && big[9] == 0x02);
+
+   constexpr auto extracted{[&big] {
+      float value{};
+      details::byte_order::load<ByteOrder::little>(big.data() + 4, value);
+      return value;
+   }()};
+   static_assert(extracted == -2.0f);
+
+   std::array<std::uint8_t, 12> runtime{};
+   details::byte_order::store<ByteOrder::big>(runtime.data(), std::uint32_t{0x01020304});
+   details::byte_order::store<ByteOrder::little>(runtime.data() + 4, -2.0f);
+   details::byte_order::store<ByteOrder::big>(runtime.data() + 8, Command::Ping);
+   EXPECT_EQ(runtime, big);
+}
@@ -0,0 +1,304 @@
+//
+// Copyright (C) 2019 Tomasz Jankowski tomasz.jankowski.mail AT gmail.com>
+//
+// This is part of GBee library.
+//
+// GBee is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GBee is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <gbee/gbee.hpp>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <unistd.h>
+#include <vector>
+
+enum class Record
+{
+   Timestamp,
+   Source,
+   Kind
+};
+
+enum class Kind : std::uint8_t
+{
+   Data,
+   Command,
+   Beacon
+};
+
+using namespace gbee;
+
+using RecordGroup = Group<LittleEndianField<Record::Timestamp, std::uint32_t>,
+                          LittleEndianField<Record::Source, std::uint16_t>,
+                          Field<Record::Kind, Kind>>;
+
+using RecordFrame = Frame<0, RecordGroup>;
+
+using RecordView = FrameView<0, RecordGroup>;
+
+using PlainCapture = Capture<RecordView, IndexFields<Record::Timestamp, Record::Source>>;
+
+using DeltaCapture = Capture<RecordView,
+                             IndexFields<Record::Timestamp, Record::Source>,
+                             DeltaFields<Record::Timestamp>>;
+
+struct Directory
+{
+   Directory()
+   {
+      std::filesystem::remove_all(path);
+   }
+
+   ~Directory()
+   {
+      std::filesystem::remove_all(path);
+   }
+
+   const std::filesystem::path path{
+     std::filesystem::temp_directory_path() /
+     ("gbee-" + std::to_string(::getpid()) + "-" +
+      ::testing::UnitTest::GetInstance()->current_test_info()->name())};
+};
+
+// Frame i: timestamps grow by 10, sources cycle through 8 values, payload of i % 5 bytes.
+struct Recorded
+{
+   explicit Recorded(std::uint32_t i)
+     : index{i}
+   {
+      frame.inject<Record::Timestamp>(1000 + i * 10);
+      frame.inject<Record::Source>(static_cast<std::uint16_t>(0x100 + i % 8));
+      frame.inject<Record::Kind>(static_cast<Kind>(i % 3));
+      for(std::size_t j = 0; j < payload_length(); ++j) {
+         buffer[RecordFrame::size + j] = static_cast<std::uint8_t>(i + j);
+      }
+   }
+
+   std::size_t
+   payload_length() const
+   {
+      return index % 5;
+   }
+
+   std::uint32_t index;
+   std::array<std::uint8_t, RecordFrame::size + 4> buffer{};
+   RecordFrame frame{buffer.data(), buffer.size()};
+};
+
+template<typename CaptureType>
+static void
+record(typename CaptureType::Writer& writer, std::uint32_t first, std::uint32_t count)
+{
+   for(std::uint32_t i = first; i < first + count; ++i) {
+      const Recorded recorded{i};
+      writer.append(recorded.frame, recorded.payload_length());
+   }
+}
+
+static std::vector<std::uint8_t>
+expected_bytes(std::uint32_t i)
+{
+   const Recorded recorded{i};
+   return {recorded.buffer.begin(),
+           recorded.buffer.begin() + RecordFrame::size + recorded.payload_length()};
+}
+
+TEST(Capture, round_trip)
+{
+   Directory directory;
+   {
+      PlainCapture::Writer writer{directory.path, 16};
+      record<PlainCapture>(writer, 0, 100);
+   }
+
+   const std::vector<std::filesystem::path> segments{PlainCapture::segments(directory.path)};
+   ASSERT_EQ(segments.size(), 1);
+   EXPECT_EQ(segments[0].filename(), "00000000.capture");
+
+   const PlainCapture::Reader reader{segments[0]};
+   EXPECT_FALSE(reader.recovered());
+   EXPECT_EQ(reader.block_count(), 7);
+   EXPECT_EQ(reader.frame_count(), 100);
+
+   std::uint32_t i{0};
+   const Span<const std::uint8_t> bytes{reader.bytes()};
+   EXPECT_EQ(reader.for_each([&](const RecordView& frame) {
+      EXPECT_GE(frame.buffer, bytes.data());
+      EXPECT_LE(frame.buffer + frame.buffer_size, bytes.data() + bytes.size());
+      EXPECT_EQ(std::vector<std::uint8_t>(frame.buffer, frame.buffer + frame.buffer_size),
+                expected_bytes(i++));
+   }),
+             100);
+}
+
+TEST(Capture, delta)
+{
+   Directory plain_directory;
+   Directory delta_directory;
+   {
+      PlainCapture::Writer plain{plain_directory.path, 32};
+      DeltaCapture::Writer delta{delta_directory.path / "delta", 32};
+      record<PlainCapture>(plain, 0, 200);
+      record<DeltaCapture>(delta, 0, 200);
+   }
+
+   const PlainCapture::Reader plain{PlainCapture::segments(plain_directory.path)[0]};
+   const DeltaCapture::Reader delta{DeltaCapture::segments(delta_directory.path / "delta")[0]};
+   // Four timestamp bytes become one, or two at the start of each of the 7 blocks.
+   EXPECT_EQ(plain.bytes().size() - delta.bytes().size(), 200 * 3 - 7);
+
+   std::uint32_t i{0};
+   EXPECT_EQ(delta.for_each([&](const RecordView& frame) {
+      EXPECT_EQ(std::vector<std::uint8_t>(frame.buffer, frame.buffer + frame.buffer_size),
+                expected_bytes(i++));
+   }),
+             200);
+
+   EXPECT_THROW(PlainCapture::Reader{DeltaCapture::segments(delta_directory.path / "delta")[0]},
+                std::runtime_error);
+}
+
+TEST(Capture, delta_field_order)
+{
+   using ReorderedCapture = Capture<RecordView,
+                                    IndexFields<Record::Timestamp>,
+                                    DeltaFields<Record::Source, Record::Timestamp>>;
+
+   Directory directory;
+   {
+      ReorderedCapture::Writer writer{directory.path, 32};
+      record<ReorderedCapture>(writer, 0, 100);
+   }
+
+   const ReorderedCapture::Reader reader{ReorderedCapture::segments(directory.path)[0]};
+   std::uint32_t i{0};
+   EXPECT_EQ(reader.for_each([&](const RecordView& frame) {
+      EXPECT_EQ(std::vector<std::uint8_t>(frame.buffer, frame.buffer + frame.buffer_size),
+                expected_bytes(i++));
+   }),
+             100);
+}
+
+TEST(Capture, select)
+{
+   Directory directory;
+   {
+      DeltaCapture::Writer writer{directory.path, 16};
+      record<DeltaCapture>(writer, 0, 1000);
+   }
+   const DeltaCapture::Reader reader{DeltaCapture::segments(directory.path)[0]};
+
+   std::vector<std::uint32_t> timestamps;
+   const auto collect{[&](const RecordView& frame) {
+      std::uint32_t timestamp;
+      frame.extract<Record::Timestamp>(timestamp);
+      timestamps.push_back(timestamp);
+   }};
+
+   EXPECT_EQ(
+     reader.select(collect, between<Record::Timestamp>(std::uint32_t{1995}, std::uint32_t{2040})),
+     5);
+   EXPECT_THAT(timestamps, ::testing::ElementsAre(2000, 2010, 2020, 2030, 2040));
+
+   timestamps.clear();
+   EXPECT_EQ(reader.select(collect,
+                           between<Record::Timestamp>(std::uint32_t{1000}, std::uint32_t{1400}),
+                           equal_to<Record::Source>(std::uint16_t{0x103})),
+             5);
+   EXPECT_THAT(timestamps, ::testing::ElementsAre(1030, 1110, 1190, 1270, 1350));
+
+   timestamps.clear();
+   EXPECT_EQ(reader.select(collect, equal_to<Record::Kind>(Kind::Beacon),
+                           between<Record::Timestamp>(std::uint32_t{1000}, std::uint32_t{1100})),
+             3);
+   EXPECT_THAT(timestamps, ::testing::ElementsAre(1020, 1050, 1080));
+
+   EXPECT_EQ(reader.select(collect, equal_to<Record::Source>(std::uint16_t{0x200})), 0);
+}
+
+TEST(Capture, rotation)
+{
+   Directory directory;
+   {
+      PlainCapture::Writer writer{directory.path, 10, 1000};
+      record<PlainCapture>(writer, 0, 300);
+   }
+   {
+      PlainCapture::Writer writer{directory.path, 10, 1000};
+      record<PlainCapture>(writer, 300, 5);
+   }
+
+   const std::vector<std::filesystem::path> segments{PlainCapture::segments(directory.path)};
+   ASSERT_GE(segments.size(), 3);
+   std::uint32_t i{0};
+   for(const std::filesystem::path& segment : segments) {
+      const PlainCapture::Reader reader{segment};
+      reader.for_each([&](const RecordView& frame) {
+         EXPECT_EQ(std::vector<std::uint8_t>(frame.buffer, frame.buffer + frame.buffer_size),
+                   expected_bytes(i++));
+      });
+   }
+   EXPECT_EQ(i, 305);
+   EXPECT_EQ(PlainCapture::Reader{segments.back()}.frame_count(), 5);
+}
+
+TEST(Capture, recovery)
+{
+   Directory directory;
+   const std::filesystem::path copy{directory.path / "copy.capture"};
+   {
+      DeltaCapture::Writer writer{directory.path, 16};
+      record<DeltaCapture>(writer, 0, 50);
+      writer.flush();
+      std::filesystem::copy_file(DeltaCapture::segments(directory.path)[0], copy);
+   }
+   std::filesystem::resize_file(copy, std::filesystem::file_size(copy) - 2);
+
+   const DeltaCapture::Reader reader{copy};
+   EXPECT_TRUE(reader.recovered());
+   EXPECT_EQ(reader.block_count(), 4);
+   EXPECT_EQ(reader.frame_count(), 49);
+
+   std::vector<std::uint32_t> timestamps;
+   EXPECT_EQ(reader.select(
+               [&](const RecordView& frame) {
+                  std::uint32_t timestamp;
+                  frame.extract<Record::Timestamp>(timestamp);
+                  timestamps.push_back(timestamp);
+               },
+               between<Record::Timestamp>(std::uint32_t{1460}, std::uint32_t{2000})),
+             3);
+   EXPECT_THAT(timestamps, ::testing::ElementsAre(1460, 1470, 1480));
+}
+
+TEST(Capture, invalid)
+{
+   Directory directory;
+   std::filesystem::create_directories(directory.path);
+   EXPECT_THROW(PlainCapture::Reader{directory.path / "missing.capture"}, std::system_error);
+
+   const std::filesystem::path path{directory.path / "00000000.capture"};
+   {
+      PlainCapture::Writer writer{directory.path};
+      record<PlainCapture>(writer, 0, 10);
+   }
+   std::filesystem::resize_file(path, 10);
+   EXPECT_THROW(PlainCapture::Reader{path}, std::runtime_error);
+}
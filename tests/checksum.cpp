@@ -0,0 +1,186 @@
+//
+// Copyright (C) 2019 Tomasz Jankowski tomasz.jankowski.mail AT gmail.com>
+//
+// This is part of GBee library.
+//
+// GBee is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GBee is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#include <array>
+#include <cstdint>
+#include <gbee/gbee.hpp>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <vector>
+
+enum class Header
+{
+   Control,
+   Sequence,
+   Pan,
+   Destination
+};
+
+enum class Flags
+{
+   Security,
+   Pending,
+   Reserved
+};
+
+enum class Trailer
+{
+   Fcs
+};
+
+using namespace gbee;
+
+using HeaderGroup = Group<LittleEndianField<Header::Control, std::uint16_t>,
+                          Field<Header::Sequence, std::uint8_t>,
+                          LittleEndianField<Header::Pan, std::uint16_t>,
+                          BigEndianField<Header::Destination, std::uint64_t>>;
+
+using FlagsGroup = Group<BitField<Flags::Security, bool, 1>,
+                         BitField<Flags::Pending, bool, 1>,
+                         BitField<Flags::Reserved, std::uint8_t, 6>>;
+
+template<typename Algorithm>
+static typename Algorithm::value_type
+bitwise(const std::uint8_t* data, std::size_t size)
+{
+   auto state{Algorithm::initial};
+   for(std::size_t i = 0; i < size; ++i) {
+      state ^= data[i];
+      for(int bit = 0; bit < 8; ++bit) {
+         state = (state & 1) ? (state >> 1) ^ Algorithm::polynomial : state >> 1;
+      }
+   }
+   return state ^ Algorithm::final_xor;
+}
+
+static std::vector<std::uint8_t>
+make_data(std::size_t size)
+{
+   std::vector<std::uint8_t> data(size);
+   for(std::size_t i = 0; i < size; ++i) {
+      data[i] = static_cast<std::uint8_t>(i * 31 + 7);
+   }
+   return data;
+}
+
+TEST(Checksum, check_values)
+{
+   static constexpr std::array<std::uint8_t, 9> digits{
+     {'1', '2', '3', '4', '5', '6', '7', '8', '9'}};
+   static_assert(details::checksum::compute<Crc16Kermit>(digits.data(), digits.size()) == 0x2189);
+   static_assert(details::checksum::compute<Crc32c>(digits.data(), digits.size()) == 0xe3069283);
+   EXPECT_EQ(details::checksum::compute<Crc16Kermit>(digits.data(), digits.size()), 0x2189);
+   EXPECT_EQ(details::checksum::compute<Crc32c>(digits.data(), digits.size()), 0xe3069283);
+}
+
+TEST(Checksum, matches_bitwise)
+{
+   const std::vector<std::uint8_t> data{make_data(41)};
+   for(std::size_t size = 0; size <= data.size(); ++size) {
+      EXPECT_EQ(details::checksum::compute<Crc16Kermit>(data.data(), size),
+                bitwise<Crc16Kermit>(data.data(), size));
+      EXPECT_EQ(details::checksum::compute<Crc32c>(data.data(), size),
+                bitwise<Crc32c>(data.data(), size));
+   }
+}
+
+TEST(Checksum, shift)
+{
+   const std::vector<std::uint8_t> zeros(300, 0);
+   for(std::size_t size : {0, 1, 7, 8, 13, 127, 300}) {
+      EXPECT_EQ(details::checksum::shift<Crc16Kermit>(0x1234, size),
+                Crc16Kermit::update(0x1234, zeros.data(), size));
+      EXPECT_EQ(details::checksum::shift<Crc32c>(0x89abcdef, size),
+                Crc32c::update(0x89abcdef, zeros.data(), size));
+   }
+}
+
+TEST(Checksum, update_and_verify)
+{
+   using FcsFrame = Frame<0, HeaderGroup, FlagsGroup, Group<Checksum<Trailer::Fcs, Crc16Kermit>>>;
+
+   std::array<std::uint8_t, FcsFrame::size> buffer{};
+   FcsFrame frame{buffer};
+   frame.inject<Header::Control>(std::uint16_t{0x8841});
+   frame.inject<Header::Sequence>(std::uint8_t{0x17});
+   frame.inject<Header::Pan>(std::uint16_t{0xabcd});
+   frame.inject<Header::Destination>(std::uint64_t{0x0123456789abcdef});
+   frame.inject<Flags::Pending>(true);
+   frame.update_checksum<Trailer::Fcs>();
+
+   const std::uint16_t expected{bitwise<Crc16Kermit>(buffer.data(), FcsFrame::size - 2)};
+   EXPECT_EQ(buffer[FcsFrame::size - 2], static_cast<std::uint8_t>(expected));
+   EXPECT_EQ(buffer[FcsFrame::size - 1], static_cast<std::uint8_t>(expected >> 8));
+   const FrameView<0, HeaderGroup, FlagsGroup, Group<Checksum<Trailer::Fcs, Crc16Kermit>>> view{
+     buffer};
+   EXPECT_TRUE(view.verify_checksum<Trailer::Fcs>());
+
+   buffer[3] ^= 0x01;
+   EXPECT_FALSE(frame.verify_checksum<Trailer::Fcs>());
+}
+
+TEST(Checksum, inject_incremental)
+{
+   using FcsFrame = Frame<0, HeaderGroup, FlagsGroup, Group<Checksum<Trailer::Fcs, Crc32c>>>;
+
+   std::array<std::uint8_t, FcsFrame::size> buffer{};
+   FcsFrame frame{buffer};
+   frame.inject<Header::Control>(std::uint16_t{0x8841});
+   frame.inject<Header::Destination>(std::uint64_t{0x0123456789abcdef});
+   frame.update_checksum<Trailer::Fcs>();
+
+   frame.inject_incremental<Header::Sequence, Trailer::Fcs>(std::uint8_t{0x42});
+   EXPECT_TRUE(frame.verify_checksum<Trailer::Fcs>());
+   frame.inject_incremental<Header::Pan, Trailer::Fcs>(std::uint16_t{0xfffe});
+   EXPECT_TRUE(frame.verify_checksum<Trailer::Fcs>());
+   frame.inject_incremental<Header::Destination, Trailer::Fcs>(std::uint64_t{42});
+   EXPECT_TRUE(frame.verify_checksum<Trailer::Fcs>());
+   frame.inject_incremental<Flags::Reserved, Trailer::Fcs>(std::uint8_t{0x2a});
+   EXPECT_TRUE(frame.verify_checksum<Trailer::Fcs>());
+   frame.inject_incremental<Flags::Security, Trailer::Fcs>(true);
+   EXPECT_TRUE(frame.verify_checksum<Trailer::Fcs>());
+
+   std::uint8_t reserved{0};
+   frame.extract<Flags::Reserved>(reserved);
+   EXPECT_EQ(reserved, 0x2a);
+}
+
+TEST(Checksum, field_range)
+{
+   using RangeFrame =
+     Frame<0,
+           Group<Checksum<Trailer::Fcs, Crc32c, FieldRange<Header::Sequence, Header::Pan>>>,
+           HeaderGroup>;
+
+   std::array<std::uint8_t, RangeFrame::size> buffer{};
+   RangeFrame frame{buffer};
+   frame.inject<Header::Sequence>(std::uint8_t{0x01});
+   frame.inject<Header::Pan>(std::uint16_t{0x0203});
+   frame.update_checksum<Trailer::Fcs>();
+
+   const std::array<std::uint8_t, 3> covered{{0x01, 0x03, 0x02}};
+   std::uint32_t checksum{0};
+   frame.extract<Trailer::Fcs>(checksum);
+   EXPECT_EQ(checksum, bitwise<Crc32c>(covered.data(), covered.size()));
+
+   frame.inject<Header::Destination>(std::uint64_t{0xffffffffffffffff});
+   EXPECT_TRUE(frame.verify_checksum<Trailer::Fcs>());
+   frame.inject_incremental<Header::Pan, Trailer::Fcs>(std::uint16_t{0x0405});
+   EXPECT_TRUE(frame.verify_checksum<Trailer::Fcs>());
+}
@@ -0,0 +1,231 @@
+//
+// Copyright (C) 2019 Tomasz Jankowski tomasz.jankowski.mail AT gmail.com>
+//
+// This is part of GBee library.
+//
+// GBee is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GBee is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#include <cstdint>
+#include <gbee/gbee.hpp>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <stdexcept>
+
+enum class Control
+{
+   Type,
+   Security,
+   DestinationMode,
+   SourceMode,
+   Sequence
+};
+
+enum class ShortDestination
+{
+   Pan,
+   Address
+};
+
+enum class ExtendedDestination
+{
+   Pan,
+   Address
+};
+
+enum class ShortSource
+{
+   Address
+};
+
+enum class Auxiliary
+{
+   Control,
+   Counter
+};
+
+enum class Command
+{
+   Id
+};
+
+using namespace gbee;
+
+using ControlGroup = Group<BitField<Control::Type, std::uint8_t, 3>,
+                           BitField<Control::Security, bool, 1>,
+                           BitField<Control::DestinationMode, std::uint8_t, 2>,
+                           BitField<Control::SourceMode, std::uint8_t, 2>,
+                           Field<Control::Sequence, std::uint8_t>>;
+
+using ShortDestinationGroup =
+  Group<Field<ShortDestination::Pan, std::uint16_t>,
+        Field<ShortDestination::Address, std::uint16_t>>;
+
+using ExtendedDestinationGroup = Group<Field<ExtendedDestination::Pan, std::uint16_t>,
+                                       Field<ExtendedDestination::Address, std::uint64_t>>;
+
+using ShortSourceGroup = Group<Field<ShortSource::Address, std::uint16_t>>;
+
+using AuxiliaryGroup =
+  Group<Field<Auxiliary::Control, std::uint8_t>, Field<Auxiliary::Counter, std::uint32_t>>;
+
+using CommandGroup = Group<Field<Command::Id, std::uint8_t>>;
+
+using ShortDestinationOption = OptionalGroup<ShortDestinationGroup, Control::DestinationMode, 2>;
+
+using ExtendedDestinationOption =
+  OptionalGroup<ExtendedDestinationGroup, Control::DestinationMode, 3>;
+
+using ShortSourceOption = OptionalGroup<ShortSourceGroup, Control::SourceMode, 2>;
+
+using AuxiliaryOption = OptionalGroup<AuxiliaryGroup, Control::Security, true>;
+
+using MacFrame = ConditionalFrame<0,
+                                  ControlGroup,
+                                  ShortDestinationOption,
+                                  ExtendedDestinationOption,
+                                  ShortSourceOption,
+                                  AuxiliaryOption,
+                                  CommandGroup>;
+
+using MacFrameView = ConditionalFrameView<0,
+                                          ControlGroup,
+                                          ShortDestinationOption,
+                                          ExtendedDestinationOption,
+                                          ShortSourceOption,
+                                          AuxiliaryOption,
+                                          CommandGroup>;
+
+TEST(ConditionalFrame, validate)
+{
+   EXPECT_EQ(ControlGroup::size, 2u);
+   EXPECT_EQ(MacFrame::min_size, 3u);
+   EXPECT_EQ(MacFrame::max_size, 24u);
+   EXPECT_TRUE((OptionalGroup<ShortSourceGroup, Control::SourceMode, 2, 3>::is_present(3)));
+   EXPECT_FALSE((OptionalGroup<ShortSourceGroup, Control::SourceMode, 2, 3>::is_present(1)));
+}
+
+TEST(ConditionalFrame, extract)
+{
+   const std::array<std::uint8_t, 11> buffer{
+     {0xa3, 0x42, 0x34, 0x12, 0xff, 0xff, 0x01, 0x00, 0xaa, 0x55, 0x00}};
+
+   const MacFrameView view{buffer};
+
+   EXPECT_EQ(view.size(), 9u);
+   EXPECT_TRUE(view.has<Control>());
+   EXPECT_TRUE(view.has<ShortDestination>());
+   EXPECT_FALSE(view.has<ExtendedDestination>());
+   EXPECT_TRUE(view.has<ShortSource>());
+   EXPECT_FALSE(view.has<Auxiliary>());
+   EXPECT_TRUE(view.has<Command>());
+
+   std::uint16_t pan{0};
+   view.extract<ShortDestination::Pan>(pan);
+   EXPECT_EQ(pan, 0x1234);
+
+   std::uint16_t destination{0};
+   view.extract<ShortDestination::Address>(destination);
+   EXPECT_EQ(destination, 0xffff);
+
+   std::uint16_t source{0};
+   view.extract<ShortSource::Address>(source);
+   EXPECT_EQ(source, 0x0001);
+
+   std::uint8_t command{0};
+   view.extract<Command::Id>(command);
+   EXPECT_EQ(command, 0xaa);
+
+   EXPECT_THAT(view.payload(), ::testing::ElementsAre(0x55, 0x00));
+}
+
+TEST(ConditionalFrame, inject)
+{
+   std::array<std::uint8_t, 20> buffer{{0}};
+   MacFrame frame{buffer};
+   EXPECT_EQ(frame.size(), 3u);
+
+   const std::uint8_t extended_mode{3};
+   frame.inject<Control::DestinationMode>(extended_mode);
+   frame.inject<Control::Security>(true);
+   frame.refresh();
+   EXPECT_EQ(frame.size(), 18u);
+   EXPECT_TRUE(frame.has<ExtendedDestination>());
+   EXPECT_TRUE(frame.has<Auxiliary>());
+   EXPECT_FALSE(frame.has<ShortSource>());
+
+   const std::uint64_t address{0x0102030405060708};
+   frame.inject<ExtendedDestination::Address>(address);
+   const std::uint32_t counter{0xa1a2a3a4};
+   frame.inject<Auxiliary::Counter>(counter);
+   const std::uint8_t command{0x7e};
+   frame.inject<Command::Id>(command);
+
+   EXPECT_THAT(buffer, ::testing::ElementsAre(0x38, 0x00, 0x00, 0x00, 0x08, 0x07, 0x06, 0x05, 0x04,
+                                              0x03, 0x02, 0x01, 0x00, 0xa4, 0xa3, 0xa2, 0xa1, 0x7e,
+                                              0x00, 0x00));
+}
+
+TEST(ConditionalFrame, discriminant_refreshes_layout)
+{
+   std::array<std::uint8_t, 20> buffer{{0}};
+   MacFrame frame{buffer};
+   EXPECT_FALSE(frame.has<ShortDestination>());
+
+   frame.inject<Control::DestinationMode>(std::uint8_t{2});
+   EXPECT_TRUE(frame.has<ShortDestination>());
+   EXPECT_EQ(frame.size(), 7u);
+
+   frame.inject<ShortDestination::Address>(std::uint16_t{0xbeef});
+   frame.inject<Command::Id>(std::uint8_t{0x7e});
+   EXPECT_THAT(buffer, ::testing::ElementsAre(0x20, 0x00, 0x00, 0x00, 0xef, 0xbe, 0x7e, 0x00,
+                                              0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+                                              0x00, 0x00, 0x00, 0x00));
+}
+
+TEST(ConditionalFrame, checked_absent_group)
+{
+   std::array<std::uint8_t, 20> buffer{{0}};
+   BasicConditionalFrame<std::uint8_t, CheckEachAccess, 0, ControlGroup, ShortDestinationOption,
+                         ExtendedDestinationOption, ShortSourceOption, AuxiliaryOption,
+                         CommandGroup>
+     frame{buffer};
+
+   EXPECT_THROW(frame.inject<ShortSource::Address>(std::uint16_t{0x1234}), std::out_of_range);
+   std::uint32_t counter{0};
+   EXPECT_THROW(frame.extract<Auxiliary::Counter>(counter), std::out_of_range);
+   EXPECT_THAT(buffer, ::testing::Each(0x00));
+
+   frame.inject<Control::Security>(true);
+   frame.inject<Auxiliary::Counter>(std::uint32_t{0xa1a2a3a4});
+   frame.extract<Auxiliary::Counter>(counter);
+   EXPECT_EQ(counter, 0xa1a2a3a4);
+
+   const BasicConditionalFrame<const std::uint8_t, CheckOnce, 0, ControlGroup,
+                               ShortDestinationOption, ExtendedDestinationOption,
+                               ShortSourceOption, AuxiliaryOption, CommandGroup>
+     view{buffer};
+   std::uint16_t pan{0};
+   EXPECT_THROW(view.extract<ShortDestination::Pan>(pan), std::out_of_range);
+}
+
+TEST(ConditionalFrame, payload_short_buffer)
+{
+   // Extended destination and auxiliary header present: 18 bytes of groups over a 6 byte buffer.
+   const std::array<std::uint8_t, 6> buffer{{0x38, 0x00, 0x00, 0x00, 0x00, 0x00}};
+
+   const MacFrameView view{buffer};
+   EXPECT_EQ(view.size(), 18u);
+   EXPECT_EQ(view.payload().size(), 0u);
+}
@@ -0,0 +1,163 @@
+//
+// Copyright (C) 2019 Tomasz Jankowski tomasz.jankowski.mail AT gmail.com>
+//
+// This is part of GBee library.
+//
+// GBee is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GBee is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#include <cstdint>
+#include <gbee/gbee.hpp>
+#include <gtest/gtest.h>
+#include <type_traits>
+
+enum class Header
+{
+   Type,
+   Sequence
+};
+
+enum class Beacon
+{
+   Order
+};
+
+enum class Data
+{
+   Length
+};
+
+enum class Command
+{
+   Id
+};
+
+enum class Type : std::uint8_t
+{
+   Beacon = 0x10,
+   Data = 0x11,
+   Command = 0x13
+};
+
+using namespace gbee;
+
+using HeaderGroup = Group<Field<Header::Type, Type>, Field<Header::Sequence, std::uint8_t>>;
+
+using BeaconFrame = FrameView<0, HeaderGroup, Group<Field<Beacon::Order, std::uint8_t>>>;
+using DataFrame = FrameView<0, HeaderGroup, Group<Field<Data::Length, std::uint16_t>>>;
+using CommandFrame = FrameView<0, HeaderGroup, Group<Field<Command::Id, std::uint8_t>>>;
+
+using Dispatcher = FrameDispatcher<Discriminant<FrameView<0, HeaderGroup>, Header::Type>,
+                                   Case<Type::Beacon, BeaconFrame>,
+                                   Case<Type::Data, DataFrame>,
+                                   Case<Type::Command, CommandFrame>>;
+
+struct Handler
+{
+   void
+   operator()(const BeaconFrame& frame)
+   {
+      frame.extract<Beacon::Order>(beacon_order);
+      ++calls;
+   }
+
+   void
+   operator()(const DataFrame& frame)
+   {
+      frame.extract<Data::Length>(data_length);
+      ++calls;
+   }
+
+   void
+   operator()(const CommandFrame& frame)
+   {
+      frame.extract<Command::Id>(command_id);
+      ++calls;
+   }
+
+   std::uint8_t beacon_order{0};
+   std::uint16_t data_length{0};
+   std::uint8_t command_id{0};
+   int calls{0};
+};
+
+TEST(FrameDispatcher, validate)
+{
+   EXPECT_EQ(Dispatcher::table_size, 4u);
+}
+
+TEST(FrameDispatcher, dispatch)
+{
+   Handler handler;
+
+   const std::array<std::uint8_t, 3> beacon{{0x10, 0x01, 0x0f}};
+   EXPECT_TRUE(Dispatcher::dispatch(beacon.data(), beacon.size(), handler));
+   EXPECT_EQ(handler.beacon_order, 0x0f);
+
+   const std::array<std::uint8_t, 4> data{{0x11, 0x02, 0x34, 0x12}};
+   EXPECT_TRUE(Dispatcher::dispatch(data.data(), data.size(), handler));
+   EXPECT_EQ(handler.data_length, 0x1234);
+
+   std::array<std::uint8_t, 3> command{{0x13, 0x03, 0xee}};
+   EXPECT_TRUE(Dispatcher::dispatch(command.data(), command.size(), handler));
+   EXPECT_EQ(handler.command_id, 0xee);
+   EXPECT_EQ(handler.calls, 3);
+}
+
+TEST(FrameDispatcher, dispatch_mutable)
+{
+   using MutableCommandFrame = Frame<0, HeaderGroup, Group<Field<Command::Id, std::uint8_t>>>;
+   using CommandDispatcher = FrameDispatcher<Discriminant<FrameView<0, HeaderGroup>, Header::Type>,
+                                             Case<Type::Command, MutableCommandFrame>>;
+
+   std::array<std::uint8_t, 3> command{{0x13, 0x03, 0x00}};
+   EXPECT_TRUE(CommandDispatcher::dispatch(command.data(), command.size(), [](auto frame) {
+      const std::uint8_t id{0xee};
+      frame.template inject<Command::Id>(id);
+   }));
+   EXPECT_EQ(command[2], 0xee);
+}
+
+TEST(FrameDispatcher, reject_unknown)
+{
+   Handler handler;
+
+   for(const std::uint8_t type : {0x00, 0x0f, 0x12, 0x14, 0xff}) {
+      const std::array<std::uint8_t, 4> buffer{{type, 0x00, 0x00, 0x00}};
+      EXPECT_FALSE(Dispatcher::dispatch(buffer.data(), buffer.size(), handler));
+   }
+
+   const std::array<std::uint8_t, 1> truncated{{0x10}};
+   EXPECT_FALSE(Dispatcher::dispatch(truncated.data(), truncated.size(), handler));
+
+   int generic_calls{0};
+   const std::array<std::uint8_t, 3> beacon{{0x10, 0x01, 0x0f}};
+   EXPECT_TRUE(Dispatcher::dispatch(beacon.data(), beacon.size(), [&](auto frame) {
+      generic_calls += std::is_same_v<decltype(frame), BeaconFrame> ? 1 : 100;
+   }));
+   EXPECT_EQ(generic_calls, 1);
+   EXPECT_EQ(handler.calls, 0);
+}
+
+TEST(FrameDispatcher, reject_truncated_case)
+{
+   Handler handler;
+
+   const std::array<std::uint8_t, 3> data{{0x11, 0x02, 0x34}};
+   EXPECT_FALSE(Dispatcher::dispatch(data.data(), data.size(), handler));
+
+   const std::array<std::uint8_t, 2> beacon{{0x10, 0x01}};
+   EXPECT_FALSE(Dispatcher::dispatch(beacon.data(), beacon.size(), handler));
+   EXPECT_EQ(handler.calls, 0);
+}
@@ -0,0 +1,150 @@
+//
+// Copyright (C) 2019 Tomasz Jankowski tomasz.jankowski.mail AT gmail.com>
+//
+// This is part of GBee library.
+//
+// GBee is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GBee is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <gbee/gbee.hpp>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+enum class Nwk
+{
+   Control,
+   Destination,
+   Source,
+   Radius,
+   Sequence
+};
+
+enum class Mac
+{
+   Sequence,
+   Source
+};
+
+using namespace gbee;
+
+using NwkFrame = Frame<0,
+                       Group<LittleEndianField<Nwk::Control, std::uint16_t>,
+                             LittleEndianField<Nwk::Destination, std::uint16_t>,
+                             LittleEndianField<Nwk::Source, std::uint16_t>,
+                             Field<Nwk::Radius, std::uint8_t>,
+                             Field<Nwk::Sequence, std::uint8_t>>>;
+
+using NwkTable = DuplicateTable<NwkFrame, 64, Nwk::Source, Nwk::Sequence>;
+
+struct Broadcast
+{
+   Broadcast(std::uint16_t source, std::uint8_t sequence, std::uint8_t radius = 30)
+   {
+      frame.inject<Nwk::Source>(source);
+      frame.inject<Nwk::Sequence>(sequence);
+      frame.inject<Nwk::Radius>(radius);
+   }
+
+   std::array<std::uint8_t, NwkFrame::size> buffer{};
+   NwkFrame frame{buffer.data(), buffer.size()};
+};
+
+TEST(DuplicateTable, insert)
+{
+   EXPECT_EQ(NwkTable::key_size, 3);
+
+   NwkTable table{100};
+   EXPECT_FALSE(table.contains(Broadcast{0x1234, 7}.frame, 0));
+   EXPECT_TRUE(table.insert(Broadcast{0x1234, 7}.frame, 0));
+   EXPECT_TRUE(table.contains(Broadcast{0x1234, 7}.frame, 10));
+   EXPECT_FALSE(table.insert(Broadcast{0x1234, 7, 29}.frame, 10));
+   EXPECT_TRUE(table.insert(Broadcast{0x1234, 8}.frame, 10));
+   EXPECT_TRUE(table.insert(Broadcast{0x4321, 7}.frame, 10));
+   EXPECT_FALSE(table.insert(Broadcast{0x1234, 7}.frame, 99));
+
+   EXPECT_FALSE(table.contains(Broadcast{0x1234, 7}.frame, 100));
+   EXPECT_TRUE(table.insert(Broadcast{0x1234, 7}.frame, 100));
+   EXPECT_FALSE(table.insert(Broadcast{0x1234, 7}.frame, 150));
+
+   // Stamps taken by a thread with a later clock reading are not expired.
+   EXPECT_FALSE(table.insert(Broadcast{0x1234, 8}.frame, 5));
+}
+
+TEST(DuplicateTable, wide_key)
+{
+   using MacFrame = Frame<0,
+                          Group<Field<Mac::Sequence, std::uint8_t>,
+                                LittleEndianField<Mac::Source, std::uint64_t>>>;
+   using MacTable = DuplicateTable<MacFrame, 16, Mac::Source, Mac::Sequence>;
+   EXPECT_EQ(MacTable::key_size, 9);
+
+   MacTable table{1000};
+   std::array<std::uint8_t, MacFrame::size> buffer{};
+   MacFrame frame{buffer.data(), buffer.size()};
+   frame.inject<Mac::Source>(std::uint64_t{0x0011223344556677});
+   frame.inject<Mac::Sequence>(std::uint8_t{1});
+   EXPECT_TRUE(table.insert(frame, 0));
+   EXPECT_FALSE(table.insert(frame, 1));
+
+   frame.inject<Mac::Sequence>(std::uint8_t{2});
+   EXPECT_TRUE(table.insert(frame, 2));
+   frame.inject<Mac::Source>(std::uint64_t{0x0011223344556678});
+   EXPECT_TRUE(table.insert(frame, 3));
+}
+
+TEST(DuplicateTable, full)
+{
+   using SmallTable = DuplicateTable<NwkFrame, 4, Nwk::Source, Nwk::Sequence>;
+   SmallTable table{1000};
+   for(std::uint8_t sequence = 0; sequence < 4; ++sequence) {
+      EXPECT_TRUE(table.insert(Broadcast{1, sequence}.frame, sequence));
+   }
+   EXPECT_TRUE(table.insert(Broadcast{1, 4}.frame, 4));
+   EXPECT_FALSE(table.contains(Broadcast{1, 0}.frame, 4));
+   for(std::uint8_t sequence = 1; sequence < 5; ++sequence) {
+      EXPECT_TRUE(table.contains(Broadcast{1, sequence}.frame, 4));
+   }
+}
+
+TEST(DuplicateTable, threads)
+{
+   using SharedTable = DuplicateTable<NwkFrame, 4096, Nwk::Source, Nwk::Sequence>;
+   SharedTable table{1000000};
+   std::vector<std::atomic<std::uint32_t>> accepted(512);
+
+   std::vector<std::thread> threads;
+   for(std::uint32_t thread_index = 0; thread_index < 4; ++thread_index) {
+      threads.emplace_back([&table, &accepted, thread_index] {
+         for(std::uint32_t i = 0; i < accepted.size(); ++i) {
+            const std::uint32_t key{(i * 7 + thread_index * 13) % 512};
+            const Broadcast broadcast{static_cast<std::uint16_t>(key >> 8),
+                                      static_cast<std::uint8_t>(key)};
+            if(table.insert(broadcast.frame, i)) {
+               ++accepted[key];
+            }
+         }
+      });
+   }
+   for(std::thread& thread : threads) {
+      thread.join();
+   }
+   for(const std::atomic<std::uint32_t>& count : accepted) {
+      EXPECT_EQ(count, 1);
+   }
+}
@@ -21,6 +21,7 @@
 #include <gbee/gbee.hpp>
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
+#include <stdexcept>
 #include <type_traits>
 
 enum class Foo1
@@ -141,3 +142,282 @@ TEST(Field, extract)
    frame.extract<Foo2::E>(e_value);
    EXPECT_EQ(e_value, 0x55);
 }
+
+TEST(Frame, inject_all)
+{
+   std::array<std::uint8_t, 20> buffer{{0}};
+   FooFrame frame{buffer};
+
+   using values_type = std::tuple<std::uint16_t, std::uint32_t, std::uint8_t, std::uint64_t,
+                                  std::uint8_t, std::uint32_t>;
+   static_assert(std::is_same_v<FooFrame::values_type, values_type>);
+
+   frame.inject_all({0x1111, 0x22222222, 0x33, 0x4444444444444444, 0x55, 0x66666666});
+   EXPECT_THAT(buffer,
+               ::testing::ElementsAre(0x11, 0x11, 0x22, 0x22, 0x22, 0x22, 0x33, 0x44, 0x44, 0x44,
+                                      0x44, 0x44, 0x44, 0x44, 0x44, 0x55, 0x66, 0x66, 0x66, 0x66));
+}
+
+TEST(Frame, extract_all)
+{
+   std::array<uint8_t, 20> buffer{{0x11, 0x11, 0x22, 0x22, 0x22, 0x22, 0x33, 0x44, 0x44, 0x44,
+                                   0x44, 0x44, 0x44, 0x44, 0x44, 0x55, 0x66, 0x66, 0x66, 0x66}};
+   FooFrame frame{buffer};
+
+   const auto [a_value, b_value, c_value, d_value, e_value, f_value] = frame.extract_all();
+   EXPECT_EQ(a_value, 0x1111);
+   EXPECT_EQ(b_value, 0x22222222);
+   EXPECT_EQ(c_value, 0x33);
+   EXPECT_EQ(d_value, 0x4444444444444444);
+   EXPECT_EQ(e_value, 0x55);
+   EXPECT_EQ(f_value, 0x66666666);
+}
+
+enum class Window
+{
+   Flag,
+   Small,
+   Wide,
+   Pair,
+   Span,
+   Tail
+};
+
+// 13 bytes, so the bit field run straddles the end of the first 8 byte window.
+using WindowGroup = Group<Field<Window::Flag, std::uint16_t>,
+                          ArrayField<Window::Pair, std::uint8_t, 3>,
+                          BigEndianField<Window::Small, std::int16_t>,
+                          BitField<Window::Span, std::uint16_t, 12>,
+                          BitField<Window::Tail, bool, 4>,
+                          BigEndianField<Window::Wide, std::uint32_t>>;
+
+template<typename FrameType, typename Values, std::size_t... indexes>
+static void
+inject_each(FrameType& frame, const Values& values, std::index_sequence<indexes...>)
+{
+   (frame.template inject<std::tuple_element_t<indexes, typename FrameType::fields_type>::id>(
+      std::get<indexes>(values)),
+    ...);
+}
+
+TEST(Frame, inject_all_windows)
+{
+   using WindowFrame = Frame<0, WindowGroup>;
+   static_assert(WindowFrame::size == 13);
+
+   const WindowFrame::values_type values{
+     0xa55a, {{1, 2, 3}}, -2, std::uint16_t{0xabc}, true, 0x01020304};
+   std::array<std::uint8_t, WindowFrame::size + 2> expected{};
+   expected.fill(0xee);
+   WindowFrame expected_frame{expected.data() + 1, WindowFrame::size};
+   inject_each(expected_frame, values, std::make_index_sequence<6>{});
+
+   std::array<std::uint8_t, WindowFrame::size + 2> buffer{};
+   buffer.fill(0xee);
+   WindowFrame frame{buffer.data() + 1, WindowFrame::size};
+   frame.inject_all(values);
+   EXPECT_EQ(buffer, expected);
+   EXPECT_EQ(frame.extract_all(), values);
+
+   using ShortFrame = Frame<0, Group<BigEndianField<Window::Small, std::uint16_t>,
+                                     BitField<Window::Span, std::uint8_t, 3>,
+                                     BitField<Window::Tail, std::uint8_t, 5>,
+                                     Field<Window::Wide, std::uint32_t>>>;
+   std::array<std::uint8_t, ShortFrame::size + 1> short_buffer{};
+   short_buffer.fill(0xee);
+   ShortFrame short_frame{short_buffer.data(), ShortFrame::size};
+   short_frame.inject_all({0x1234, 5, 17, 0xdeadbeef});
+   EXPECT_THAT(short_buffer,
+               ::testing::ElementsAre(0x12, 0x34, 17 << 3 | 5, 0xef, 0xbe, 0xad, 0xde, 0xee));
+   EXPECT_EQ(short_frame.extract_all(), (ShortFrame::values_type{0x1234, 5, 17, 0xdeadbeef}));
+}
+
+using FooFrameView = FrameView<0, FooGroup1, FooGroup2, FooGroup3>;
+
+TEST(FrameView, validate)
+{
+   static_assert(std::is_trivially_copyable_v<FooFrameView>);
+   static_assert(std::is_trivially_copyable_v<FooFrame>);
+   static_assert(sizeof(FooFrameView) == sizeof(const std::uint8_t*) + sizeof(std::size_t));
+   static_assert(FooFrameView::size == FooFrame::size);
+   static_assert(std::is_convertible_v<FooFrame, FooFrameView>);
+   static_assert(!std::is_convertible_v<FooFrameView, FooFrame>);
+}
+
+TEST(FrameView, extract)
+{
+   const std::array<uint8_t, 20> buffer{{0x11, 0x11, 0x22, 0x22, 0x22, 0x22, 0x33, 0x44, 0x44,
+                                         0x44, 0x44, 0x44, 0x44, 0x44, 0x44, 0x55, 0x66, 0x66,
+                                         0x66, 0x66}};
+
+   FooFrameView view{buffer};
+   EXPECT_EQ(view.buffer, buffer.data());
+   EXPECT_TRUE(view.has_valid_buffer_size());
+
+   std::uint32_t b_value{0};
+   view.extract<Foo1::B>(b_value);
+   EXPECT_EQ(b_value, 0x22222222);
+
+   const FooFrameView raw_view{buffer.data() + 2, buffer.size() - 2};
+   EXPECT_FALSE(raw_view.has_valid_buffer_size());
+
+   std::uint16_t a_value{0};
+   raw_view.extract<Foo1::A>(a_value);
+   EXPECT_EQ(a_value, 0x2222);
+
+   const auto [a, b, c, d, e, f] = view.extract_all();
+   EXPECT_EQ(a, 0x1111);
+   EXPECT_EQ(f, 0x66666666);
+}
+
+TEST(Frame, raw_buffer)
+{
+   std::array<std::uint8_t, 24> buffer{{0}};
+
+   FooFrame frame{buffer.data() + 4, FooFrame::size};
+   EXPECT_TRUE(frame.has_valid_buffer_size());
+
+   const std::uint16_t a_value{0x1111};
+   frame.inject<Foo1::A>(a_value);
+   EXPECT_EQ(buffer[4], 0x11);
+   EXPECT_EQ(buffer[5], 0x11);
+
+   const FooFrameView view{frame};
+   std::uint16_t extracted{0};
+   view.extract<Foo1::A>(extracted);
+   EXPECT_EQ(extracted, a_value);
+}
+
+enum class Header
+{
+   Sequence,
+   Length
+};
+
+using HeaderGroup =
+  Group<Field<Header::Sequence, std::uint8_t>, Field<Header::Length, std::uint8_t>>;
+
+using PayloadFrame = Frame<8, HeaderGroup>;
+
+TEST(Frame, payload)
+{
+   std::array<std::uint8_t, 10> buffer{{0x01, 0x03, 0xaa, 0xbb, 0xcc, 0xdd}};
+
+   const FrameView<8, HeaderGroup> view{buffer};
+
+   const Span<const std::uint8_t> tail{view.payload()};
+   EXPECT_EQ(tail.data(), buffer.data() + 2);
+   EXPECT_EQ(tail.size(), 8u);
+
+   const Span<const std::uint8_t> payload{view.payload<Header::Length>()};
+   EXPECT_EQ(payload.data(), buffer.data() + 2);
+   EXPECT_THAT(payload, ::testing::ElementsAre(0xaa, 0xbb, 0xcc));
+}
+
+TEST(Frame, payload_short_buffer)
+{
+   std::array<std::uint8_t, 4> buffer{{0x01, 0x02, 0x03, 0x04}};
+
+   const FrameView<0, FooGroup1> view{buffer.data(), buffer.size()};
+   EXPECT_EQ(view.payload().size(), 0u);
+
+   const FrameView<0, HeaderGroup> header{buffer.data(), 1};
+   EXPECT_EQ(header.payload().size(), 0u);
+}
+
+TEST(Frame, resize_payload)
+{
+   std::array<std::uint8_t, 10> buffer{{0}};
+   PayloadFrame frame{buffer};
+
+   const Span<std::uint8_t> payload{frame.resize_payload<Header::Length>(2)};
+   payload[0] = 0xaa;
+   payload[1] = 0xbb;
+   EXPECT_THAT(buffer,
+               ::testing::ElementsAre(0x00, 0x02, 0xaa, 0xbb, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00));
+
+   const std::array<std::uint8_t, 3> data{{0xcc, 0xdd, 0xee}};
+   frame.append_payload<Header::Length>(data.data(), data.size());
+   EXPECT_THAT(buffer,
+               ::testing::ElementsAre(0x00, 0x05, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0x00, 0x00, 0x00));
+   EXPECT_EQ(frame.payload<Header::Length>().size(), 5u);
+}
+
+TEST(Frame, checked_payload)
+{
+   std::array<std::uint8_t, 4> buffer{{0x01, 0x05, 0xaa, 0xbb}};
+
+   const BasicFrame<const std::uint8_t, CheckEachAccess, 0, HeaderGroup> view{buffer};
+   EXPECT_THROW(view.payload<Header::Length>(), std::out_of_range);
+
+   BasicFrame<std::uint8_t, CheckOnce, 0, HeaderGroup> frame{buffer};
+   EXPECT_THROW(frame.resize_payload<Header::Length>(3), std::out_of_range);
+   EXPECT_EQ(frame.resize_payload<Header::Length>(2).size(), 2u);
+}
+
+TEST(Frame, payload_length_range)
+{
+   std::array<std::uint8_t, 512> buffer{{0}};
+   Frame<0, HeaderGroup> frame{buffer};
+
+   EXPECT_THROW(frame.resize_payload<Header::Length>(300), std::out_of_range);
+   EXPECT_EQ(buffer[1], 0x00);
+   EXPECT_EQ(frame.resize_payload<Header::Length>(255).size(), 255u);
+
+   const std::array<std::uint8_t, 1> data{{0xaa}};
+   EXPECT_THROW(frame.append_payload<Header::Length>(data.data(), data.size()), std::out_of_range);
+   EXPECT_EQ(buffer[1], 0xff);
+}
+
+enum class Beacon
+{
+   Control,
+   Interval,
+   Permit,
+   Order,
+   Address
+};
+
+enum class BeaconTrailer
+{
+   Fcs
+};
+
+using BeaconHeader = Group<BigEndianField<Beacon::Control, std::uint16_t>,
+                           LittleEndianField<Beacon::Interval, float>,
+                           BitField<Beacon::Permit, bool, 1>,
+                           BitField<Beacon::Order, std::uint8_t, 7>,
+                           ArrayField<Beacon::Address, std::uint16_t, 2, ByteOrder::big>>;
+using BeaconFooter = Group<Checksum<BeaconTrailer::Fcs, Crc16Kermit>>;
+using BeaconFrame = Frame<0, BeaconHeader, BeaconFooter>;
+
+static constexpr std::array<std::uint8_t, BeaconFrame::size> beacon_template{[] {
+   std::array<std::uint8_t, BeaconFrame::size> buffer{};
+   BeaconFrame frame{buffer};
+   frame.inject<Beacon::Control>(std::uint16_t{0x8000});
+   frame.inject<Beacon::Interval>(1.5f);
+   frame.inject<Beacon::Permit>(true);
+   frame.inject<Beacon::Order>(std::uint8_t{15});
+   frame.inject<Beacon::Address>(std::array<std::uint16_t, 2>{{0x0102, 0x0304}});
+   frame.update_checksum<BeaconTrailer::Fcs>();
+   return buffer;
+}()};
+
+TEST(Frame, constant_evaluation)
+{
+   static_assert(beacon_template[0] == 0x80 && beacon_template[1] == 0x00);
+   static_assert(beacon_template[5] == 0x3f && beacon_template[4] == 0xc0);
+   static_assert(beacon_template[6] == (15 << 1 | 1));
+   static_assert(beacon_template[7] == 0x01 && beacon_template[10] == 0x04);
+
+   constexpr FrameView<0, BeaconHeader, BeaconFooter> view{beacon_template};
+   static_assert(view.verify_checksum<BeaconTrailer::Fcs>());
+   static_assert(std::get<1>(view.extract_all()) == 1.5f);
+   static_assert(std::get<3>(view.extract_all()) == 15);
+
+   std::array<std::uint8_t, BeaconFrame::size> runtime{};
+   BeaconFrame frame{runtime};
+   frame.inject_all(view.extract_all());
+   frame.update_checksum<BeaconTrailer::Fcs>();
+   EXPECT_EQ(runtime, beacon_template);
+}
@@ -105,3 +105,256 @@ TEST(Group, extract)
    FooGroup::extract<Foo::E>(buffer.data(), buffer.size(), e_value);
    EXPECT_EQ(e_value, 0x55);
 }
+
+enum class FrameControl
+{
+   Type,
+   Security,
+   Pending,
+   AckRequest,
+   PanIdCompression,
+   Reserved,
+   DestinationMode,
+   Version,
+   SourceMode,
+   Sequence
+};
+
+enum class FrameType : std::uint8_t
+{
+   Beacon,
+   Data,
+   Ack,
+   Command
+};
+
+using FrameControlGroup = Group<BitField<FrameControl::Type, FrameType, 3>,
+                                BitField<FrameControl::Security, bool, 1>,
+                                BitField<FrameControl::Pending, bool, 1>,
+                                BitField<FrameControl::AckRequest, bool, 1>,
+                                BitField<FrameControl::PanIdCompression, bool, 1>,
+                                BitField<FrameControl::Reserved, std::uint8_t, 3>,
+                                BitField<FrameControl::DestinationMode, std::uint8_t, 2>,
+                                BitField<FrameControl::Version, std::uint8_t, 2>,
+                                BitField<FrameControl::SourceMode, std::uint8_t, 2>,
+                                Field<FrameControl::Sequence, std::uint8_t>>;
+
+TEST(BitField, validate)
+{
+   using Bar = BitField<FrameControl::Version, std::uint8_t, 2>;
+   EXPECT_EQ(Bar::id, FrameControl::Version);
+   EXPECT_EQ(Bar::bit_size, 2u);
+   EXPECT_TRUE(Bar::is_bit_field);
+   EXPECT_FALSE((Field<Foo::A, std::uint8_t>::is_bit_field));
+   EXPECT_EQ(FrameControlGroup::size, 3u);
+   EXPECT_EQ(FrameControlGroup::offset<FrameControl::DestinationMode>::bit_value, 10u);
+   EXPECT_EQ(FrameControlGroup::offset<FrameControl::Sequence>::value, 2u);
+}
+
+TEST(Group, inject_bit_field)
+{
+   std::array<std::uint8_t, 3> buffer{{0}};
+   static_assert(buffer.size() == FrameControlGroup::size);
+
+   FrameControlGroup::inject<FrameControl::Type>(buffer.data(), buffer.size(), FrameType::Data);
+   EXPECT_THAT(buffer, ::testing::ElementsAre(0x01, 0x00, 0x00));
+
+   FrameControlGroup::inject<FrameControl::AckRequest>(buffer.data(), buffer.size(), true);
+   FrameControlGroup::inject<FrameControl::PanIdCompression>(buffer.data(), buffer.size(), true);
+   EXPECT_THAT(buffer, ::testing::ElementsAre(0x61, 0x00, 0x00));
+
+   const std::uint8_t short_mode{2};
+   FrameControlGroup::inject<FrameControl::DestinationMode>(buffer.data(), buffer.size(),
+                                                             short_mode);
+   FrameControlGroup::inject<FrameControl::SourceMode>(buffer.data(), buffer.size(), short_mode);
+   EXPECT_THAT(buffer, ::testing::ElementsAre(0x61, 0x88, 0x00));
+
+   const std::uint8_t sequence{0x42};
+   FrameControlGroup::inject<FrameControl::Sequence>(buffer.data(), buffer.size(), sequence);
+   EXPECT_THAT(buffer, ::testing::ElementsAre(0x61, 0x88, 0x42));
+
+   const std::uint8_t overflowing_mode{7};
+   FrameControlGroup::inject<FrameControl::DestinationMode>(buffer.data(), buffer.size(),
+                                                             overflowing_mode);
+   FrameControlGroup::inject<FrameControl::AckRequest>(buffer.data(), buffer.size(), false);
+   EXPECT_THAT(buffer, ::testing::ElementsAre(0x41, 0x8c, 0x42));
+}
+
+TEST(Group, extract_bit_field)
+{
+   const std::array<std::uint8_t, 3> buffer{{0x69, 0xdc, 0x42}};
+
+   FrameType type{};
+   FrameControlGroup::extract<FrameControl::Type>(buffer.data(), buffer.size(), type);
+   EXPECT_EQ(type, FrameType::Data);
+
+   bool security{false};
+   FrameControlGroup::extract<FrameControl::Security>(buffer.data(), buffer.size(), security);
+   EXPECT_TRUE(security);
+
+   bool pending{true};
+   FrameControlGroup::extract<FrameControl::Pending>(buffer.data(), buffer.size(), pending);
+   EXPECT_FALSE(pending);
+
+   std::uint8_t destination_mode{0};
+   FrameControlGroup::extract<FrameControl::DestinationMode>(buffer.data(), buffer.size(),
+                                                              destination_mode);
+   EXPECT_EQ(destination_mode, 3);
+
+   std::uint8_t version{0};
+   FrameControlGroup::extract<FrameControl::Version>(buffer.data(), buffer.size(), version);
+   EXPECT_EQ(version, 1);
+
+   std::uint8_t source_mode{0};
+   FrameControlGroup::extract<FrameControl::SourceMode>(buffer.data(), buffer.size(), source_mode);
+   EXPECT_EQ(source_mode, 3);
+
+   std::uint8_t sequence{0};
+   FrameControlGroup::extract<FrameControl::Sequence>(buffer.data(), buffer.size(), sequence);
+   EXPECT_EQ(sequence, 0x42);
+}
+
+TEST(Group, inject_all_bit_fields)
+{
+   std::array<std::uint8_t, 3> buffer{{0xff, 0xff, 0xff}};
+
+   FrameControlGroup::inject_all(buffer.data(), buffer.size(),
+                                 FrameControlGroup::values_type{FrameType::Data, false, false, true,
+                                                                true, 0, 2, 0, 2, 0x42});
+   EXPECT_THAT(buffer, ::testing::ElementsAre(0x61, 0x88, 0x42));
+
+   FrameControlGroup::values_type values;
+   FrameControlGroup::extract_all(buffer.data(), buffer.size(), values);
+   EXPECT_EQ(std::get<0>(values), FrameType::Data);
+   EXPECT_TRUE(std::get<3>(values));
+   EXPECT_EQ(std::get<8>(values), 2);
+   EXPECT_EQ(std::get<9>(values), 0x42);
+}
+
+enum class Odd
+{
+   Low,
+   High,
+   Wide,
+   Flags,
+   Tail
+};
+
+using OddRunGroup = Group<BitField<Odd::Low, std::uint8_t, 4>,
+                          BitField<Odd::High, std::uint32_t, 20>,
+                          BitField<Odd::Wide, std::uint64_t, 36>,
+                          BitField<Odd::Flags, std::uint8_t, 4>,
+                          Field<Odd::Tail, std::uint8_t>>;
+
+TEST(Group, odd_sized_bit_runs)
+{
+   static_assert(OddRunGroup::size == 9);
+   std::array<std::uint8_t, OddRunGroup::size> buffer{{0}};
+   buffer[8] = 0xee;
+
+   OddRunGroup::inject<Odd::Low>(buffer.data(), buffer.size(), std::uint8_t{0xa});
+   OddRunGroup::inject<Odd::High>(buffer.data(), buffer.size(), std::uint32_t{0x12345});
+   OddRunGroup::inject<Odd::Wide>(buffer.data(), buffer.size(), std::uint64_t{0xfedcba987});
+   OddRunGroup::inject<Odd::Flags>(buffer.data(), buffer.size(), std::uint8_t{0x5});
+   EXPECT_THAT(buffer,
+               ::testing::ElementsAre(0x5a, 0x34, 0x12, 0x87, 0xa9, 0xcb, 0xed, 0x5f, 0xee));
+
+   std::uint32_t high{0};
+   std::uint64_t wide{0};
+   std::uint8_t flags{0};
+   std::uint8_t tail{0};
+   OddRunGroup::extract<Odd::High>(buffer.data(), buffer.size(), high);
+   OddRunGroup::extract<Odd::Wide>(buffer.data(), buffer.size(), wide);
+   OddRunGroup::extract<Odd::Flags>(buffer.data(), buffer.size(), flags);
+   OddRunGroup::extract<Odd::Tail>(buffer.data(), buffer.size(), tail);
+   EXPECT_EQ(high, 0x12345u);
+   EXPECT_EQ(wide, 0xfedcba987u);
+   EXPECT_EQ(flags, 0x5);
+   EXPECT_EQ(tail, 0xee);
+}
+
+TEST(Group, signed_bit_fields)
+{
+   enum class Signed
+   {
+      Small,
+      Offset,
+      Full
+   };
+
+   using SignedGroup = Group<BitField<Signed::Small, std::int8_t, 4>,
+                             BitField<Signed::Offset, std::int16_t, 12>,
+                             BitField<Signed::Full, std::int8_t, 8>>;
+   std::array<std::uint8_t, SignedGroup::size> buffer{{0}};
+
+   SignedGroup::inject<Signed::Small>(buffer.data(), buffer.size(), std::int8_t{-1});
+   SignedGroup::inject<Signed::Offset>(buffer.data(), buffer.size(), std::int16_t{-2048});
+   SignedGroup::inject<Signed::Full>(buffer.data(), buffer.size(), std::int8_t{-128});
+   EXPECT_THAT(buffer, ::testing::ElementsAre(0x0f, 0x80, 0x80));
+
+   std::int8_t small{0};
+   std::int16_t offset{0};
+   std::int8_t full{0};
+   SignedGroup::extract<Signed::Small>(buffer.data(), buffer.size(), small);
+   SignedGroup::extract<Signed::Offset>(buffer.data(), buffer.size(), offset);
+   SignedGroup::extract<Signed::Full>(buffer.data(), buffer.size(), full);
+   EXPECT_EQ(small, -1);
+   EXPECT_EQ(offset, -2048);
+   EXPECT_EQ(full, -128);
+
+   SignedGroup::inject<Signed::Small>(buffer.data(), buffer.size(), std::int8_t{7});
+   SignedGroup::extract<Signed::Small>(buffer.data(), buffer.size(), small);
+   EXPECT_EQ(small, 7);
+}
+
+TEST(ArrayField, inject_extract)
+{
+   enum class Table
+   {
+      Count,
+      Addresses
+   };
+
+   using TableGroup = Group<Field<Table::Count, std::uint8_t>,
+                            ArrayField<Table::Addresses, std::uint16_t, 10, ByteOrder::big>>;
+   static_assert(TableGroup::size == 21);
+
+   std::array<std::uint16_t, 10> addresses{};
+   for(std::size_t i = 0; i < addresses.size(); ++i) {
+      addresses[i] = static_cast<std::uint16_t>(0x1100 + i);
+   }
+
+   std::array<std::uint8_t, 21> buffer{{0}};
+   TableGroup::inject<Table::Addresses>(buffer.data(), buffer.size(), addresses);
+   EXPECT_EQ(buffer[0], 0x00);
+   EXPECT_EQ(buffer[1], 0x11);
+   EXPECT_EQ(buffer[2], 0x00);
+   EXPECT_EQ(buffer[19], 0x11);
+   EXPECT_EQ(buffer[20], 0x09);
+
+   std::array<std::uint16_t, 10> extracted{};
+   TableGroup::extract<Table::Addresses>(buffer.data(), buffer.size(), extracted);
+   EXPECT_EQ(extracted, addresses);
+}
+
+TEST(Group, lookup_unordered_ids)
+{
+   using ReversedGroup = Group<Field<Foo::E, std::uint8_t>,
+                               Field<Foo::C, std::uint16_t>,
+                               Field<Foo::A, std::uint32_t>,
+                               Field<Foo::D, std::uint8_t>,
+                               Field<Foo::B, std::uint8_t>>;
+   static_assert(ReversedGroup::offset<Foo::E>::value == 0);
+   static_assert(ReversedGroup::offset<Foo::C>::value == 1);
+   static_assert(ReversedGroup::offset<Foo::A>::value == 3);
+   static_assert(ReversedGroup::offset<Foo::D>::value == 7);
+   static_assert(ReversedGroup::offset<Foo::B>::value == 8);
+   EXPECT_TRUE((std::is_same_v<ReversedGroup::field_value_type<Foo::C>, std::uint16_t>) );
+   EXPECT_TRUE((std::is_same_v<ReversedGroup::field_value_type<Foo::A>, std::uint32_t>) );
+
+   std::array<std::uint8_t, 9> buffer{{0}};
+   ReversedGroup::inject<Foo::A>(buffer.data(), buffer.size(), std::uint32_t{0x11223344});
+   std::uint32_t value{0};
+   ReversedGroup::extract<Foo::A>(buffer.data(), buffer.size(), value);
+   EXPECT_EQ(value, 0x11223344);
+}
@@ -31,6 +31,11 @@ TEST(Helpers, are_values_unique)
 
    EXPECT_FALSE((are_values_unique<1, 1>) );
    EXPECT_FALSE((are_values_unique<1, 2, 3, 2>) );
+   EXPECT_TRUE((are_values_unique<9, 4, 7, 1, 8, 2, 6, 3, 5, 0>) );
+   EXPECT_FALSE((are_values_unique<9, 4, 7, 1, 8, 2, 6, 3, 5, 9>) );
+   EXPECT_TRUE((are_values_unique<1, 'a', 2u>) );
+   EXPECT_FALSE((are_values_unique<1, 1u>) );
+   EXPECT_FALSE((are_values_unique<97, 'a', 2u>) );
 }
 
 TEST(Helpers, are_types_unique)
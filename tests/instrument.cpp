@@ -0,0 +1,194 @@
+//
+// Copyright (C) 2019 Tomasz Jankowski tomasz.jankowski.mail AT gmail.com>
+//
+// This is part of GBee library.
+//
+// GBee is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GBee is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <gbee/gbee.hpp>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+enum class Nwk
+{
+   Control,
+   Destination,
+   Source,
+   Radius,
+   Sequence
+};
+
+enum class Mac
+{
+   Type,
+   Security,
+   Pending
+};
+
+using namespace gbee;
+
+using NwkGroup = Group<LittleEndianField<Nwk::Control, std::uint16_t>,
+                       LittleEndianField<Nwk::Destination, std::uint16_t>,
+                       LittleEndianField<Nwk::Source, std::uint16_t>,
+                       Field<Nwk::Radius, std::uint8_t>,
+                       Field<Nwk::Sequence, std::uint8_t>>;
+
+using MacGroup = Group<BitField<Mac::Type, std::uint8_t, 3>,
+                       BitField<Mac::Security, bool, 1>,
+                       BitField<Mac::Pending, std::uint8_t, 4>>;
+
+using Counted = FieldCounters<>;
+
+using CountedFrame = InstrumentedFrame<Counted, 0, MacGroup, NwkGroup>;
+
+struct Recorder
+{
+   template<typename Group, auto id, typename Accessor>
+   static void
+   access(Access access, Accessor&& accessor)
+   {
+      accesses.emplace_back(access, field_name<id>);
+      accessor();
+   }
+
+   static inline std::vector<std::pair<Access, std::string_view>> accesses;
+};
+
+TEST(Instrument, field_name)
+{
+   EXPECT_EQ(field_name<Nwk::Source>, "Nwk::Source");
+   EXPECT_EQ(field_name<Mac::Pending>, "Mac::Pending");
+   EXPECT_FALSE(details::is_instrumented<Unchecked>);
+   EXPECT_TRUE((details::is_instrumented<Instrumented<Counted, CheckOnce>>));
+}
+
+TEST(Instrument, counters)
+{
+   std::array<std::uint8_t, CountedFrame::size> buffer{};
+   CountedFrame frame{buffer};
+   frame.inject<Nwk::Source>(std::uint16_t{0x1234});
+   frame.inject<Mac::Security>(true);
+   for(int i = 0; i < 3; ++i) {
+      std::uint16_t source;
+      frame.extract<Nwk::Source>(source);
+      EXPECT_EQ(source, 0x1234);
+   }
+   bool security;
+   frame.extract<Mac::Security>(security);
+   EXPECT_TRUE(security);
+   EXPECT_EQ(buffer[0], 0x08);
+
+   const std::vector<FieldReport> report{Counted::report<CountedFrame>()};
+   ASSERT_EQ(report.size(), 8);
+   EXPECT_EQ(report[0].name, "Mac::Type");
+   EXPECT_EQ(report[1].name, "Mac::Security");
+   EXPECT_EQ(report[1].bit_offset, 3);
+   EXPECT_EQ(report[1].bit_size, 1);
+   EXPECT_EQ(report[1].injects, 1);
+   EXPECT_EQ(report[1].extracts, 1);
+   EXPECT_EQ(report[5].name, "Nwk::Source");
+   EXPECT_EQ(report[5].offset, 5);
+   EXPECT_EQ(report[5].injects, 1);
+   EXPECT_EQ(report[5].extracts, 3);
+   EXPECT_EQ(report[5].samples, 0);
+   EXPECT_EQ(report[6].injects + report[6].extracts, 0);
+
+   Counted::reset<CountedFrame>();
+   for(const FieldReport& field : Counted::report<CountedFrame>()) {
+      EXPECT_EQ(field.injects + field.extracts, 0);
+   }
+}
+
+TEST(Instrument, bulk_counters)
+{
+   std::array<std::uint8_t, CountedFrame::size> buffer{};
+   CountedFrame frame{buffer};
+   const CountedFrame::values_type values{5, true, 9, 0x1111, 0x2222, 0x3333, 0x44, 0x55};
+   frame.inject_all(values);
+   EXPECT_EQ(frame.extract_all(), values);
+   for(const FieldReport& field : Counted::report<CountedFrame>()) {
+      EXPECT_EQ(field.injects, 1) << field.name;
+      EXPECT_EQ(field.extracts, 1) << field.name;
+   }
+
+   NwkGroup::values_type nwk_values{};
+   NwkGroup::extract_all<Instrumented<Counted>>(buffer.data(), buffer.size(), nwk_values,
+                                                MacGroup::size);
+   EXPECT_EQ(std::get<2>(nwk_values), 0x3333);
+   NwkGroup::inject_all<Instrumented<Counted>>(buffer.data(), buffer.size(), nwk_values,
+                                               MacGroup::size);
+   const std::vector<FieldReport> report{Counted::report<CountedFrame>()};
+   EXPECT_EQ(report[0].injects + report[0].extracts, 2);
+   EXPECT_EQ(report[5].injects, 2);
+   EXPECT_EQ(report[5].extracts, 2);
+
+   Counted::reset<CountedFrame>();
+}
+
+TEST(Instrument, sampling)
+{
+   using Sampled = FieldCounters<4>;
+   using SampledFrame = InstrumentedFrameView<Sampled, 0, NwkGroup>;
+
+   const std::array<std::uint8_t, SampledFrame::size> buffer{};
+   const SampledFrame frame{buffer};
+   for(int i = 0; i < 10; ++i) {
+      std::uint8_t radius;
+      frame.extract<Nwk::Radius>(radius);
+   }
+   const std::vector<FieldReport> report{Sampled::report<SampledFrame>()};
+   EXPECT_EQ(report[3].extracts, 10);
+   EXPECT_EQ(report[3].samples, 3);
+
+   std::FILE* stream{std::tmpfile()};
+   ASSERT_NE(stream, nullptr);
+   Sampled::dump<SampledFrame>(stream);
+   std::rewind(stream);
+   std::string text;
+   for(int c = std::fgetc(stream); c != EOF; c = std::fgetc(stream)) {
+      text.push_back(static_cast<char>(c));
+   }
+   std::fclose(stream);
+   EXPECT_THAT(text, ::testing::HasSubstr("Nwk::Radius"));
+   EXPECT_THAT(text, ::testing::HasSubstr("Nwk::Sequence"));
+}
+
+TEST(Instrument, user_probe)
+{
+   using RecordedFrame =
+     BasicFrame<std::uint8_t, Instrumented<Recorder, CheckEachAccess>, 0, NwkGroup>;
+
+   std::array<std::uint8_t, RecordedFrame::size> buffer{};
+   RecordedFrame frame{buffer};
+   frame.inject<Nwk::Radius>(std::uint8_t{30});
+   std::uint8_t radius;
+   frame.extract<Nwk::Radius>(radius);
+   EXPECT_EQ(radius, 30);
+   EXPECT_THAT(Recorder::accesses,
+               ::testing::ElementsAre(std::make_pair(Access::inject, "Nwk::Radius"),
+                                      std::make_pair(Access::extract, "Nwk::Radius")));
+
+   RecordedFrame short_frame{buffer.data(), 4};
+   std::uint16_t source;
+   EXPECT_THROW(short_frame.extract<Nwk::Source>(source), std::out_of_range);
+}
@@ -0,0 +1,171 @@
+//
+// Copyright (C) 2019 Tomasz Jankowski tomasz.jankowski.mail AT gmail.com>
+//
+// This is part of GBee library.
+//
+// GBee is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GBee is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#include <array>
+#include <cstdint>
+#include <gbee/gbee.hpp>
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+
+enum class Mac
+{
+   Control,
+   Counter,
+   Pan,
+   Address,
+   Mode,
+   Flags,
+   Hops
+};
+
+enum class Nwk
+{
+   Source,
+   Radius
+};
+
+enum class App
+{
+   Cluster
+};
+
+using namespace gbee;
+
+using MacGroup = Group<Field<Mac::Control, std::uint8_t>,
+                       LittleEndianField<Mac::Counter, std::uint32_t>,
+                       LittleEndianField<Mac::Pan, std::uint16_t>,
+                       LittleEndianField<Mac::Address, std::uint64_t>,
+                       BitField<Mac::Mode, std::uint8_t, 3>,
+                       BitField<Mac::Flags, std::uint8_t, 5>,
+                       ArrayField<Mac::Hops, std::uint16_t, 3>>;
+
+using NwkGroup =
+  Group<LittleEndianField<Nwk::Source, std::uint16_t>, Field<Nwk::Radius, std::uint8_t>>;
+
+using AppGroup = Group<LittleEndianField<App::Cluster, std::uint32_t>>;
+
+using WireFrame = Frame<0, MacGroup>;
+
+static_assert(misaligned_field_count<WireFrame> == 4);
+static_assert(misaligned_field_count<WireFrame, 8> == 3);
+static_assert(misaligned_field_count<AlignedFrame<8, 0, ReorderedGroup<MacGroup>>> == 0);
+
+TEST(Layout, field_layouts)
+{
+   constexpr auto layouts{field_layouts<WireFrame, 8>};
+   ASSERT_EQ(layouts.size(), 7);
+   EXPECT_EQ(layouts[1].name, "Mac::Counter");
+   EXPECT_EQ(layouts[1].offset, 1);
+   EXPECT_EQ(layouts[1].alignment, 4);
+   EXPECT_FALSE(layouts[1].is_aligned);
+   EXPECT_EQ(layouts[3].offset, 7);
+   EXPECT_FALSE(layouts[3].is_aligned);
+   EXPECT_EQ(layouts[5].bit_offset, 15 * 8 + 3);
+   EXPECT_EQ(layouts[5].bit_size, 5);
+   EXPECT_TRUE(layouts[5].is_aligned);
+   EXPECT_EQ(layouts[6].offset, 16);
+   EXPECT_EQ(layouts[6].alignment, 2);
+   EXPECT_TRUE(layouts[6].is_aligned);
+}
+
+TEST(Layout, reordered_group)
+{
+   using Internal = AlignedFrame<8, 0, ReorderedGroup<MacGroup>>;
+   EXPECT_EQ(Internal::size, WireFrame::size);
+   EXPECT_EQ(Internal::field_offset<Mac::Address>, 0);
+   EXPECT_EQ(Internal::field_offset<Mac::Counter>, 8);
+   EXPECT_EQ(Internal::field_offset<Mac::Pan>, 12);
+   EXPECT_EQ(Internal::field_offset<Mac::Hops>, 14);
+   EXPECT_EQ(Internal::field_offset<Mac::Control>, 20);
+   EXPECT_EQ(Internal::field_bit_offset<Mac::Mode>, 21 * 8);
+   EXPECT_EQ(Internal::field_bit_offset<Mac::Flags>, 21 * 8 + 3);
+
+   alignas(8) std::array<std::uint8_t, Internal::size> buffer{};
+   Internal frame{buffer};
+   frame.inject<Mac::Address>(std::uint64_t{0x0011223344556677});
+   frame.inject<Mac::Counter>(std::uint32_t{0x8899aabb});
+   frame.inject<Mac::Flags>(std::uint8_t{0x15});
+   frame.inject<Mac::Hops>(std::array<std::uint16_t, 3>{{1, 2, 3}});
+
+   std::uint64_t address;
+   std::uint32_t counter;
+   std::uint8_t flags;
+   std::array<std::uint16_t, 3> hops;
+   frame.extract<Mac::Address>(address);
+   frame.extract<Mac::Counter>(counter);
+   frame.extract<Mac::Flags>(flags);
+   frame.extract<Mac::Hops>(hops);
+   EXPECT_EQ(address, 0x0011223344556677);
+   EXPECT_EQ(counter, 0x8899aabb);
+   EXPECT_EQ(flags, 0x15);
+   EXPECT_EQ(hops, (std::array<std::uint16_t, 3>{{1, 2, 3}}));
+   EXPECT_EQ(buffer[0], 0x77);
+   EXPECT_EQ(buffer[8], 0xbb);
+   EXPECT_EQ(buffer[21], 0x15 << 3);
+}
+
+TEST(Layout, reordered_frame)
+{
+   using Internal = ReorderedFrame<8, 0, NwkGroup, MacGroup, AppGroup>;
+   EXPECT_EQ(Internal::alignment, 8);
+   EXPECT_TRUE((std::is_same_v<Internal::groups_type,
+                               std::tuple<ReorderedGroup<MacGroup>, AppGroup, NwkGroup>>));
+   EXPECT_EQ(Internal::field_offset<App::Cluster>, 22);
+   EXPECT_EQ(Internal::field_offset<Nwk::Source>, 26);
+   EXPECT_EQ(misaligned_field_count<Internal>, 1);
+}
+
+TEST(Layout, aligned_policy)
+{
+   using Checked = BasicFrame<std::uint8_t, Aligned<16, CheckEachAccess>, 0, MacGroup>;
+   EXPECT_EQ(Checked::alignment, 16);
+   EXPECT_EQ(WireFrame::alignment, 1);
+   EXPECT_EQ((BasicFrame<std::uint8_t, Instrumented<FieldCounters<>, Aligned<8>>, 0, AppGroup>::
+                alignment),
+             8);
+
+   alignas(16) std::array<std::uint8_t, Checked::size> buffer{};
+   Checked frame{buffer.data(), 5};
+   EXPECT_THROW(frame.inject<Mac::Address>(std::uint64_t{1}), std::out_of_range);
+   frame.inject<Mac::Counter>(std::uint32_t{0x01020304});
+   EXPECT_EQ(buffer[1], 0x04);
+
+   alignas(16) std::array<std::uint8_t, Checked::size + 8> padded{};
+   EXPECT_THROW((Checked{padded.data() + 8, Checked::size}), std::invalid_argument);
+   EXPECT_THROW((BasicFrame<std::uint8_t, Aligned<8, CheckOnce>, 0, MacGroup>{padded.data() + 4,
+                                                                            Checked::size}),
+                std::invalid_argument);
+   EXPECT_NO_THROW((AlignedFrame<16, 0, MacGroup>{padded.data() + 8, Checked::size}));
+}
+
+TEST(Layout, constant_evaluation)
+{
+   using Internal = AlignedFrame<8, 0, ReorderedGroup<MacGroup>>;
+   constexpr std::uint32_t counter{[] {
+      std::array<std::uint8_t, Internal::size> buffer{};
+      Internal frame{buffer};
+      frame.inject<Mac::Counter>(std::uint32_t{42});
+      std::uint32_t value{};
+      frame.extract<Mac::Counter>(value);
+      return value;
+   }()};
+   EXPECT_EQ(counter, 42);
+}
@@ -0,0 +1,94 @@
+//
+// Copyright (C) 2019 Tomasz Jankowski tomasz.jankowski.mail AT gmail.com>
+//
+// This is part of GBee library.
+//
+// GBee is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GBee is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#include <atomic>
+#include <cstdint>
+#include <gbee/gbee.hpp>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <vector>
+
+enum class Record
+{
+   Sequence,
+   Pan,
+   Source
+};
+
+using namespace gbee;
+
+using RecordFrame = Frame<0,
+                          Group<Field<Record::Sequence, std::uint8_t>,
+                                LittleEndianField<Record::Pan, std::uint16_t>,
+                                BigEndianField<Record::Source, std::uint64_t>>>;
+
+TEST(ThreadPool, parallel_for)
+{
+   for(std::size_t thread_count : {1, 2, 3, 8}) {
+      ThreadPool pool{thread_count};
+      EXPECT_EQ(pool.thread_count(), thread_count);
+      for(std::size_t count : {0, 1, 5, 1000}) {
+         std::vector<std::atomic<int>> calls(count);
+         pool.parallel_for(count, [&](std::size_t index) { ++calls[index]; });
+         for(const std::atomic<int>& call : calls) {
+            EXPECT_EQ(call, 1);
+         }
+      }
+   }
+}
+
+TEST(ThreadPool, uneven_work)
+{
+   ThreadPool pool{4};
+   std::atomic<std::uint64_t> sum{0};
+   pool.parallel_for(64, [&](std::size_t index) {
+      std::uint64_t local{0};
+      for(std::size_t i = 0; i < (index < 8 ? 200000 : 10); ++i) {
+         local += i;
+      }
+      sum += local > 0 ? index : 0;
+   });
+   EXPECT_EQ(sum, 63 * 64 / 2);
+}
+
+TEST(ThreadPool, chunk_frames)
+{
+   EXPECT_EQ(details::parallel::chunk_frames<RecordFrame::size> * RecordFrame::size % 64, 0);
+   EXPECT_EQ(details::parallel::chunk_frames<64> * 64, 16384);
+   EXPECT_GE(details::parallel::chunk_frames<20000>, 1);
+}
+
+TEST(ThreadPool, encode_batch)
+{
+   const std::size_t count{10007};
+   std::vector<RecordFrame::values_type> values(count);
+   for(std::size_t i = 0; i < count; ++i) {
+      values[i] = {static_cast<std::uint8_t>(i), static_cast<std::uint16_t>(i * 3), i * 0x1001};
+   }
+
+   std::vector<std::uint8_t> expected(count * RecordFrame::size);
+   for(std::size_t i = 0; i < count; ++i) {
+      RecordFrame{expected.data() + i * RecordFrame::size, RecordFrame::size}.inject_all(values[i]);
+   }
+
+   ThreadPool pool{4};
+   std::vector<std::uint8_t> output(count * RecordFrame::size);
+   encode_batch<RecordFrame>(pool, values.data(), count, output.data());
+   EXPECT_EQ(output, expected);
+}
@@ -0,0 +1,134 @@
+//
+// Copyright (C) 2019 Tomasz Jankowski tomasz.jankowski.mail AT gmail.com>
+//
+// This is part of GBee library.
+//
+// GBee is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GBee is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#include <atomic>
+#include <cstdint>
+#include <gbee/gbee.hpp>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <optional>
+#include <set>
+#include <thread>
+#include <vector>
+
+enum class Header
+{
+   Type,
+   Sequence
+};
+
+using namespace gbee;
+
+using HeaderGroup =
+  Group<Field<Header::Type, std::uint8_t>, Field<Header::Sequence, std::uint32_t>>;
+
+using PoolFrame = Frame<100, HeaderGroup>;
+
+TEST(FramePool, slots)
+{
+   using Pool = FramePool<PoolFrame, 4>;
+   EXPECT_EQ(PoolFrame::required_size, 105);
+   EXPECT_EQ(Pool::slot_size, 128);
+
+   Pool pool;
+   std::vector<PoolFrame> frames;
+   std::set<const std::uint8_t*> buffers;
+   while(std::optional<PoolFrame> frame{pool.acquire()}) {
+      EXPECT_EQ(reinterpret_cast<std::uintptr_t>(frame->buffer) % Pool::cache_line_size, 0);
+      EXPECT_EQ(frame->buffer_size, Pool::slot_size);
+      EXPECT_TRUE(pool.owns(frame->buffer));
+      frame->inject<Header::Sequence>(std::uint32_t{42});
+      buffers.insert(frame->buffer);
+      frames.push_back(*frame);
+   }
+   EXPECT_EQ(frames.size(), 4);
+   EXPECT_EQ(buffers.size(), 4);
+
+   pool.release(FrameView<100, HeaderGroup>{frames[2]});
+   const std::optional<PoolFrame> reused{pool.acquire()};
+   ASSERT_TRUE(reused);
+   EXPECT_EQ(reused->buffer, frames[2].buffer);
+   EXPECT_FALSE(pool.acquire());
+}
+
+TEST(FramePool, cache)
+{
+   using Pool = FramePool<PoolFrame, 64>;
+   Pool pool;
+   std::vector<PoolFrame> frames;
+   {
+      Pool::Cache cache{pool};
+      while(std::optional<PoolFrame> frame{cache.acquire()}) {
+         frames.push_back(*frame);
+      }
+      EXPECT_EQ(frames.size(), 64);
+      for(const PoolFrame& frame : frames) {
+         cache.release(frame);
+      }
+   }
+
+   std::set<const std::uint8_t*> buffers;
+   while(std::optional<PoolFrame> frame{pool.acquire()}) {
+      buffers.insert(frame->buffer);
+   }
+   EXPECT_EQ(buffers.size(), 64);
+}
+
+TEST(FramePool, threads)
+{
+   using Pool = FramePool<PoolFrame, 256>;
+   Pool pool;
+   std::atomic<bool> corrupted{false};
+
+   std::vector<std::thread> threads;
+   for(std::uint32_t thread_index = 0; thread_index < 4; ++thread_index) {
+      threads.emplace_back([&pool, &corrupted, thread_index] {
+         Pool::Cache cache{pool};
+         std::vector<PoolFrame> held;
+         for(std::uint32_t i = 0; i < 20000; ++i) {
+            if(std::optional<PoolFrame> frame{i % 3 ? cache.acquire() : pool.acquire()}) {
+               frame->inject<Header::Sequence>(thread_index << 24 | i);
+               held.push_back(*frame);
+            }
+            if(held.size() > 20 || (!held.empty() && i % 2)) {
+               std::uint32_t sequence{0};
+               held.back().extract<Header::Sequence>(sequence);
+               if(sequence >> 24 != thread_index) {
+                  corrupted = true;
+               }
+               i % 5 ? cache.release(held.back()) : pool.release(held.back());
+               held.pop_back();
+            }
+         }
+         for(const PoolFrame& frame : held) {
+            cache.release(frame);
+         }
+      });
+   }
+   for(std::thread& thread : threads) {
+      thread.join();
+   }
+   EXPECT_FALSE(corrupted);
+
+   std::set<const std::uint8_t*> buffers;
+   while(std::optional<PoolFrame> frame{pool.acquire()}) {
+      buffers.insert(frame->buffer);
+   }
+   EXPECT_EQ(buffers.size(), 256);
+}
@@ -0,0 +1,116 @@
+//
+// Copyright (C) 2019 Tomasz Jankowski tomasz.jankowski.mail AT gmail.com>
+//
+// This is part of GBee library.
+//
+// GBee is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GBee is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#include <array>
+#include <cstdint>
+#include <gbee/gbee.hpp>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+enum class Mac
+{
+   Control,
+   Sequence,
+   Pan,
+   Destination,
+   Source
+};
+
+enum class Nwk
+{
+   Radius,
+   Security,
+   Hops,
+   Internal,
+   Version
+};
+
+using namespace gbee;
+
+using InternalFrame = Frame<0,
+                            Group<Field<Mac::Control, std::uint16_t>,
+                                  Field<Mac::Sequence, std::uint8_t>,
+                                  Field<Mac::Pan, std::uint16_t>,
+                                  Field<Mac::Destination, std::uint64_t>,
+                                  Field<Mac::Source, std::uint64_t>>,
+                            Group<Field<Nwk::Internal, std::uint32_t>,
+                                  Field<Nwk::Radius, std::uint8_t>,
+                                  Field<Nwk::Security, bool>,
+                                  Field<Nwk::Hops, std::uint8_t>>>;
+
+using OnAirFrame = Frame<0,
+                         Group<LittleEndianField<Mac::Control, std::uint16_t>,
+                               Field<Mac::Sequence, std::uint8_t>,
+                               LittleEndianField<Mac::Pan, std::uint16_t>,
+                               LittleEndianField<Mac::Destination, std::uint64_t>,
+                               BigEndianField<Mac::Source, std::uint64_t>>,
+                         Group<Field<Nwk::Version, std::uint8_t>,
+                               Field<Nwk::Radius, std::uint8_t>,
+                               BitField<Nwk::Security, bool, 1>,
+                               BitField<Nwk::Hops, std::uint8_t, 7>>>;
+
+TEST(Project, plan)
+{
+   using Plan = details::project::plan<InternalFrame, OnAirFrame>;
+   EXPECT_EQ(Plan::field_count, 9);
+   EXPECT_TRUE(Plan::is_copyable<0>);
+   EXPECT_FALSE(Plan::is_copyable<4>);
+   EXPECT_FALSE(Plan::is_matched<5>);
+   EXPECT_FALSE(Plan::is_copyable<7>);
+
+   // Control..Destination form one run, Radius sits behind Internal in the source.
+   ASSERT_EQ(Plan::move_count, 2);
+   EXPECT_EQ(Plan::moves[0].source, 0);
+   EXPECT_EQ(Plan::moves[0].destination, 0);
+   EXPECT_EQ(Plan::moves[0].size, 13);
+   EXPECT_EQ(Plan::moves[1].source, 25);
+   EXPECT_EQ(Plan::moves[1].destination, 22);
+   EXPECT_EQ(Plan::moves[1].size, 1);
+}
+
+TEST(Project, project)
+{
+   std::array<std::uint8_t, InternalFrame::size> internal_buffer{};
+   InternalFrame internal{internal_buffer};
+   internal.inject<Mac::Control>(std::uint16_t{0x8841});
+   internal.inject<Mac::Sequence>(std::uint8_t{0x17});
+   internal.inject<Mac::Pan>(std::uint16_t{0xabcd});
+   internal.inject<Mac::Destination>(std::uint64_t{0x0102030405060708});
+   internal.inject<Mac::Source>(std::uint64_t{0x1112131415161718});
+   internal.inject<Nwk::Internal>(std::uint32_t{0xffffffff});
+   internal.inject<Nwk::Radius>(std::uint8_t{30});
+   internal.inject<Nwk::Security>(true);
+   internal.inject<Nwk::Hops>(std::uint8_t{5});
+
+   std::array<std::uint8_t, OnAirFrame::size> on_air_buffer{};
+   on_air_buffer[21] = 0x02;
+   project(internal, OnAirFrame{on_air_buffer});
+
+   EXPECT_THAT(on_air_buffer,
+               ::testing::ElementsAre(0x41, 0x88, 0x17, 0xcd, 0xab, 0x08, 0x07, 0x06, 0x05, 0x04,
+                                      0x03, 0x02, 0x01, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17,
+                                      0x18, 0x02, 30, 0x0b));
+
+   std::array<std::uint8_t, InternalFrame::size> round_trip_buffer{};
+   project(FrameView<0, OnAirFrame::group_type<Mac::Control>, OnAirFrame::group_type<Nwk::Radius>>{
+             on_air_buffer},
+           InternalFrame{round_trip_buffer});
+   internal.inject<Nwk::Internal>(std::uint32_t{0});
+   EXPECT_EQ(round_trip_buffer, internal_buffer);
+}
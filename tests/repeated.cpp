@@ -0,0 +1,102 @@
+//
+// Copyright (C) 2019 Tomasz Jankowski tomasz.jankowski.mail AT gmail.com>
+//
+// This is part of GBee library.
+//
+// GBee is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GBee is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#include <cstdint>
+#include <gbee/gbee.hpp>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <vector>
+
+enum class Route
+{
+   Sequence,
+   Count
+};
+
+enum class Relay
+{
+   Address
+};
+
+enum class Neighbor
+{
+   Address,
+   Cost
+};
+
+using namespace gbee;
+
+using RouteGroup = Group<Field<Route::Sequence, std::uint8_t>, Field<Route::Count, std::uint8_t>>;
+
+using RelayGroup = Group<BigEndianField<Relay::Address, std::uint16_t>>;
+
+using NeighborGroup =
+  Group<LittleEndianField<Neighbor::Address, std::uint16_t>, Field<Neighbor::Cost, std::uint8_t>>;
+
+using RouteFrame = Frame<64, RouteGroup>;
+
+TEST(Repeated, contiguous_column)
+{
+   std::array<std::uint8_t, 66> buffer{{0}};
+   RouteFrame frame{buffer};
+
+   std::vector<std::uint16_t> relays(21);
+   for(std::size_t i = 0; i < relays.size(); ++i) {
+      relays[i] = static_cast<std::uint16_t>(0xa000 + i);
+   }
+
+   const RepeatedView<std::uint8_t, RelayGroup> encoded{
+     frame.resize_repeated<Route::Count, RelayGroup>(relays.size())};
+   encoded.inject_column<Relay::Address>(relays.data());
+   EXPECT_EQ(buffer[1], 21);
+   EXPECT_EQ(buffer[2], 0xa0);
+   EXPECT_EQ(buffer[3], 0x00);
+   EXPECT_EQ(buffer[42], 0xa0);
+   EXPECT_EQ(buffer[43], 0x14);
+
+   const FrameView<64, RouteGroup> view{frame};
+   const RepeatedView<const std::uint8_t, RelayGroup> decoded{
+     view.repeated<Route::Count, RelayGroup>()};
+   EXPECT_EQ(decoded.count, relays.size());
+
+   std::vector<std::uint16_t> extracted(decoded.count);
+   decoded.extract_column<Relay::Address>(extracted.data());
+   EXPECT_EQ(extracted, relays);
+
+   std::uint16_t relay{0};
+   decoded.extract<Relay::Address>(3, relay);
+   EXPECT_EQ(relay, 0xa003);
+}
+
+TEST(Repeated, strided_column)
+{
+   const std::array<std::uint8_t, 11> buffer{
+     {0x01, 0x03, 0x01, 0x00, 0x10, 0x02, 0x00, 0x20, 0x03, 0x00, 0x30}};
+
+   const FrameView<9, RouteGroup> view{buffer};
+   const auto neighbors{view.repeated<Route::Count, NeighborGroup>()};
+
+   std::array<std::uint16_t, 3> addresses{};
+   neighbors.extract_column<Neighbor::Address>(addresses.data());
+   EXPECT_THAT(addresses, ::testing::ElementsAre(1, 2, 3));
+
+   std::array<std::uint8_t, 3> costs{};
+   neighbors.extract_column<Neighbor::Cost>(costs.data());
+   EXPECT_THAT(costs, ::testing::ElementsAre(0x10, 0x20, 0x30));
+}
@@ -0,0 +1,228 @@
+//
+// Copyright (C) 2019 Tomasz Jankowski tomasz.jankowski.mail AT gmail.com>
+//
+// This is part of GBee library.
+//
+// GBee is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GBee is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#include <array>
+#include <cstdint>
+#include <gbee/gbee.hpp>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <vector>
+
+enum class Nwk
+{
+   Control,
+   Destination,
+   Source,
+   Radius,
+   Sequence
+};
+
+enum class Aux
+{
+   SecurityControl,
+   FrameCounter,
+   ExtendedSource,
+   KeySequence
+};
+
+enum class RfcNonce
+{
+   Value
+};
+
+enum class RfcHeader
+{
+   Value
+};
+
+using namespace gbee;
+
+using NwkGroup = Group<LittleEndianField<Nwk::Control, std::uint16_t>,
+                       LittleEndianField<Nwk::Destination, std::uint16_t>,
+                       LittleEndianField<Nwk::Source, std::uint16_t>,
+                       Field<Nwk::Radius, std::uint8_t>,
+                       Field<Nwk::Sequence, std::uint8_t>>;
+
+using AuxGroup = Group<Field<Aux::SecurityControl, std::uint8_t>,
+                       LittleEndianField<Aux::FrameCounter, std::uint32_t>,
+                       LittleEndianField<Aux::ExtendedSource, std::uint64_t>,
+                       Field<Aux::KeySequence, std::uint8_t>>;
+
+using SecuredFrame = Frame<0, NwkGroup, AuxGroup>;
+
+using NwkSecurity = CcmStar<Nonce<Aux::ExtendedSource, Aux::FrameCounter, Aux::SecurityControl>>;
+
+static const Aes128 key{{{0x40, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49, 0x4a, 0x4b,
+                          0x4c, 0x4d, 0x4e, 0x4f}}};
+
+static std::vector<std::uint8_t>
+make_frame(std::size_t payload_length, std::uint32_t counter)
+{
+   std::vector<std::uint8_t> buffer(SecuredFrame::size + payload_length + NwkSecurity::mic_size);
+   SecuredFrame frame{buffer.data(), buffer.size()};
+   frame.inject<Nwk::Control>(std::uint16_t{0x0248});
+   frame.inject<Nwk::Destination>(std::uint16_t{0x0000});
+   frame.inject<Nwk::Source>(std::uint16_t{0x1234});
+   frame.inject<Nwk::Radius>(std::uint8_t{0x1e});
+   frame.inject<Nwk::Sequence>(std::uint8_t{0x5a});
+   frame.inject<Aux::SecurityControl>(std::uint8_t{0x2d});
+   frame.inject<Aux::FrameCounter>(counter);
+   frame.inject<Aux::ExtendedSource>(std::uint64_t{0x0011223344556677});
+   frame.inject<Aux::KeySequence>(std::uint8_t{0x00});
+   for(std::size_t i = 0; i < payload_length; ++i) {
+      buffer[SecuredFrame::size + i] = static_cast<std::uint8_t>(i * 7 + 3);
+   }
+   return buffer;
+}
+
+TEST(Security, aes_block)
+{
+   const Aes128 fips_key{{{0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b,
+                           0x0c, 0x0d, 0x0e, 0x0f}}};
+   std::array<std::uint8_t, 16> block{{0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99,
+                                       0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff}};
+   fips_key.encrypt(block.data(), 1);
+   EXPECT_THAT(block, ::testing::ElementsAre(0x69, 0xc4, 0xe0, 0xd8, 0x6a, 0x7b, 0x04, 0x30, 0xd8,
+                                             0xcd, 0xb7, 0x80, 0x70, 0xb4, 0xc5, 0x5a));
+}
+
+TEST(Security, rfc3610_vector)
+{
+   using RfcFrame = Frame<0,
+                          Group<ArrayField<RfcNonce::Value, std::uint8_t, 13>>,
+                          Group<ArrayField<RfcHeader::Value, std::uint8_t, 8>>>;
+   using RfcSecurity =
+     CcmStar<Nonce<RfcNonce::Value>, 8, FieldRange<RfcHeader::Value, RfcHeader::Value>>;
+
+   std::array<std::uint8_t, RfcFrame::size + 23 + 8> buffer{};
+   RfcFrame frame{buffer.data(), buffer.size()};
+   frame.inject<RfcNonce::Value>(std::array<std::uint8_t, 13>{
+     {0x00, 0x00, 0x00, 0x03, 0x02, 0x01, 0x00, 0xa0, 0xa1, 0xa2, 0xa3, 0xa4, 0xa5}});
+   frame.inject<RfcHeader::Value>(
+     std::array<std::uint8_t, 8>{{0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07}});
+   for(std::size_t i = 0; i < 23; ++i) {
+      buffer[RfcFrame::size + i] = static_cast<std::uint8_t>(0x08 + i);
+   }
+
+   const Aes128 rfc_key{{{0xc0, 0xc1, 0xc2, 0xc3, 0xc4, 0xc5, 0xc6, 0xc7, 0xc8, 0xc9, 0xca, 0xcb,
+                          0xcc, 0xcd, 0xce, 0xcf}}};
+   const Span<std::uint8_t> secured{seal<RfcSecurity>(rfc_key, frame, 23)};
+   EXPECT_EQ(secured.data(), buffer.data() + RfcFrame::size);
+   EXPECT_THAT(std::vector<std::uint8_t>(secured.begin(), secured.end()),
+               ::testing::ElementsAre(0x58, 0x8c, 0x97, 0x9a, 0x61, 0xc6, 0x63, 0xd2, 0xf0, 0x66,
+                                      0xd0, 0xc2, 0xc0, 0xf9, 0x89, 0x80, 0x6d, 0x5f, 0x6b, 0x61,
+                                      0xda, 0xc3, 0x84, 0x17, 0xe8, 0xd1, 0x2c, 0xfd, 0xf9, 0x26,
+                                      0xe0));
+
+   EXPECT_TRUE(open<RfcSecurity>(rfc_key, frame, secured.size()));
+   for(std::size_t i = 0; i < 23; ++i) {
+      EXPECT_EQ(buffer[RfcFrame::size + i], 0x08 + i);
+   }
+}
+
+TEST(Security, seal_nwk_frame)
+{
+   std::vector<std::uint8_t> buffer{make_frame(20, 0x102)};
+   const std::vector<std::uint8_t> header(buffer.begin(), buffer.begin() + SecuredFrame::size);
+   SecuredFrame frame{buffer.data(), buffer.size()};
+   seal<NwkSecurity>(key, frame, 20);
+
+   EXPECT_TRUE(std::equal(header.begin(), header.end(), buffer.begin()));
+   EXPECT_THAT(std::vector<std::uint8_t>(buffer.begin() + SecuredFrame::size, buffer.end()),
+               ::testing::ElementsAre(0xde, 0x0a, 0x32, 0xeb, 0xe5, 0xfc, 0x70, 0x7d, 0xf2, 0x71,
+                                      0x4f, 0x59, 0x75, 0x85, 0xcf, 0x74, 0xcb, 0x87, 0x31, 0xa4,
+                                      0x9c, 0xc1, 0xb0, 0xae));
+}
+
+TEST(Security, open_rejects_tampering)
+{
+   const std::vector<std::uint8_t> plain{make_frame(33, 7)};
+   std::vector<std::uint8_t> buffer{plain};
+   SecuredFrame frame{buffer.data(), buffer.size()};
+   seal<NwkSecurity>(key, frame, 33);
+   const std::vector<std::uint8_t> secured{buffer};
+
+   buffer[SecuredFrame::size + 5] ^= 0x01;
+   const std::vector<std::uint8_t> tampered{buffer};
+   EXPECT_FALSE(open<NwkSecurity>(key, frame, 33 + NwkSecurity::mic_size));
+   EXPECT_EQ(buffer, tampered);
+
+   buffer = secured;
+   frame.inject<Nwk::Radius>(std::uint8_t{0x1d});
+   EXPECT_FALSE(open<NwkSecurity>(key, frame, 33 + NwkSecurity::mic_size));
+
+   buffer = secured;
+   EXPECT_TRUE(open<NwkSecurity>(key, frame, 33 + NwkSecurity::mic_size));
+   EXPECT_TRUE(std::equal(plain.begin(), plain.end() - NwkSecurity::mic_size, buffer.begin()));
+
+   EXPECT_FALSE(open<NwkSecurity>(key, frame, NwkSecurity::mic_size - 1));
+}
+
+TEST(Security, encryption_only)
+{
+   using Encrypted =
+     CcmStar<Nonce<Aux::ExtendedSource, Aux::FrameCounter, Aux::SecurityControl>, 0>;
+
+   const std::vector<std::uint8_t> plain{make_frame(17, 3)};
+   std::vector<std::uint8_t> buffer{plain};
+   SecuredFrame frame{buffer.data(), buffer.size()};
+   EXPECT_EQ(seal<Encrypted>(key, frame, 17).size(), 17);
+   EXPECT_NE(buffer, plain);
+   EXPECT_TRUE(open<Encrypted>(key, frame, 17));
+   EXPECT_EQ(buffer, plain);
+}
+
+TEST(Security, batch)
+{
+   const std::vector<std::size_t> lengths{{0, 1, 16, 17, 40, 5, 64, 3, 9}};
+   std::vector<std::vector<std::uint8_t>> buffers;
+   std::vector<std::vector<std::uint8_t>> expected;
+   std::vector<SecuredFrame> frames;
+   for(std::size_t i = 0; i < lengths.size(); ++i) {
+      buffers.push_back(make_frame(lengths[i], static_cast<std::uint32_t>(i)));
+      expected.push_back(buffers.back());
+      SecuredFrame frame{expected.back().data(), expected.back().size()};
+      seal<NwkSecurity>(key, frame, lengths[i]);
+   }
+   for(auto& buffer : buffers) {
+      frames.emplace_back(buffer.data(), buffer.size());
+   }
+
+   seal<NwkSecurity>(key, frames.data(), lengths.data(), frames.size());
+   EXPECT_EQ(buffers, expected);
+
+   buffers[4][SecuredFrame::size] ^= 0x80;
+   std::vector<std::size_t> secured_lengths;
+   for(std::size_t length : lengths) {
+      secured_lengths.push_back(length + NwkSecurity::mic_size);
+   }
+   secured_lengths[7] = 2;
+   bool authentic[9];
+   EXPECT_EQ(
+     open<NwkSecurity>(key, frames.data(), secured_lengths.data(), frames.size(), authentic), 7);
+   for(std::size_t i = 0; i < lengths.size(); ++i) {
+      EXPECT_EQ(authentic[i], i != 4 && i != 7);
+   }
+   for(std::size_t i : {0, 6}) {
+      const std::vector<std::uint8_t> plain{make_frame(lengths[i], static_cast<std::uint32_t>(i))};
+      EXPECT_TRUE(
+        std::equal(plain.begin(), plain.end() - NwkSecurity::mic_size, buffers[i].begin()));
+   }
+   EXPECT_EQ(buffers[7], expected[7]);
+}
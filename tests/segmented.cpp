@@ -0,0 +1,134 @@
+//
+// Copyright (C) 2019 Tomasz Jankowski tomasz.jankowski.mail AT gmail.com>
+//
+// This is part of GBee library.
+//
+// GBee is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GBee is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#include <array>
+#include <cstdint>
+#include <gbee/gbee.hpp>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+enum class Mac
+{
+   Control,
+   Sequence
+};
+
+enum class Nwk
+{
+   Destination,
+   Radius
+};
+
+using namespace gbee;
+
+using MacGroup =
+  Group<LittleEndianField<Mac::Control, std::uint16_t>, Field<Mac::Sequence, std::uint8_t>>;
+
+using NwkGroup =
+  Group<LittleEndianField<Nwk::Destination, std::uint16_t>, Field<Nwk::Radius, std::uint8_t>>;
+
+using MacSegment = Frame<0, MacGroup>;
+using NwkSegment = Frame<0, NwkGroup>;
+using PayloadSegment = Frame<0>;
+
+using StackFrame = SegmentedFrame<MacSegment, NwkSegment, PayloadSegment>;
+
+TEST(SegmentedFrame, validate)
+{
+   EXPECT_EQ(StackFrame::segment_count, 3);
+   EXPECT_EQ(StackFrame::size, 6);
+   EXPECT_EQ(StackFrame::segment_index<Mac::Sequence>, 0);
+   EXPECT_EQ(StackFrame::segment_index<Nwk::Radius>, 1);
+   EXPECT_TRUE((std::is_same_v<StackFrame::field_value_type<Nwk::Destination>, std::uint16_t>));
+   EXPECT_EQ(PayloadSegment::size, 0);
+}
+
+TEST(SegmentedFrame, inject_extract)
+{
+   std::array<std::uint8_t, 3> mac{};
+   std::array<std::uint8_t, 3> nwk{};
+   std::array<std::uint8_t, 4> payload{{0xde, 0xad, 0xbe, 0xef}};
+   StackFrame frame{MacSegment{mac}, NwkSegment{nwk}, PayloadSegment{payload}};
+
+   frame.inject<Mac::Control>(std::uint16_t{0x8841});
+   frame.inject<Mac::Sequence>(std::uint8_t{0x17});
+   frame.inject<Nwk::Destination>(std::uint16_t{0x0102});
+   frame.inject<Nwk::Radius>(std::uint8_t{0x1e});
+   EXPECT_THAT(mac, ::testing::ElementsAre(0x41, 0x88, 0x17));
+   EXPECT_THAT(nwk, ::testing::ElementsAre(0x02, 0x01, 0x1e));
+
+   std::uint8_t radius{0};
+   frame.extract<Nwk::Radius>(radius);
+   EXPECT_EQ(radius, 0x1e);
+   EXPECT_EQ(frame.buffer_size(), 10);
+   EXPECT_THAT(frame.segment<2>().payload(), ::testing::ElementsAre(0xde, 0xad, 0xbe, 0xef));
+}
+
+TEST(SegmentedFrame, writev)
+{
+   std::array<std::uint8_t, 3> mac{};
+   std::array<std::uint8_t, 3> nwk{};
+   std::array<std::uint8_t, 2> payload{{0xaa, 0xbb}};
+   StackFrame frame{MacSegment{mac}, NwkSegment{nwk}, PayloadSegment{payload}};
+   frame.inject<Mac::Sequence>(std::uint8_t{0x01});
+   frame.inject<Nwk::Radius>(std::uint8_t{0x02});
+
+   const std::array<iovec, 3> vectors{frame.iovecs()};
+   EXPECT_EQ(vectors[0].iov_base, mac.data());
+   EXPECT_EQ(vectors[1].iov_len, nwk.size());
+
+   int pipe_ends[2];
+   ASSERT_EQ(pipe(pipe_ends), 0);
+   EXPECT_EQ(writev(pipe_ends[1], vectors.data(), static_cast<int>(vectors.size())), 8);
+   std::array<std::uint8_t, 8> received{};
+   EXPECT_EQ(read(pipe_ends[0], received.data(), received.size()), 8);
+   close(pipe_ends[0]);
+   close(pipe_ends[1]);
+   EXPECT_THAT(received, ::testing::ElementsAre(0x00, 0x00, 0x01, 0x00, 0x00, 0x02, 0xaa, 0xbb));
+}
+
+TEST(SegmentedFrame, writev_lengths)
+{
+   std::array<std::uint8_t, 16> mac{};
+   std::array<std::uint8_t, 3> nwk{};
+   std::array<std::uint8_t, 64> payload{{0xaa, 0xbb, 0xcc}};
+   StackFrame frame{MacSegment{mac}, NwkSegment{nwk}, PayloadSegment{payload}};
+   frame.inject<Mac::Sequence>(std::uint8_t{0x01});
+   EXPECT_EQ(frame.length(), 70u);
+
+   EXPECT_EQ(frame.resize_payload<2>(3).size(), 3u);
+   EXPECT_EQ(frame.length(), 9u);
+   EXPECT_EQ(frame.buffer_size(), 83u);
+
+   const std::array<iovec, 3> vectors{frame.iovecs()};
+   EXPECT_EQ(vectors[0].iov_len, MacSegment::size);
+   EXPECT_EQ(vectors[2].iov_len, 3u);
+
+   int pipe_ends[2];
+   ASSERT_EQ(pipe(pipe_ends), 0);
+   EXPECT_EQ(writev(pipe_ends[1], vectors.data(), static_cast<int>(vectors.size())), 9);
+   std::array<std::uint8_t, 9> received{};
+   EXPECT_EQ(read(pipe_ends[0], received.data(), received.size()), 9);
+   close(pipe_ends[0]);
+   close(pipe_ends[1]);
+   EXPECT_THAT(received,
+               ::testing::ElementsAre(0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0xaa, 0xbb, 0xcc));
+}
@@ -0,0 +1,126 @@
+//
+// Copyright (C) 2019 Tomasz Jankowski tomasz.jankowski.mail AT gmail.com>
+//
+// This is part of GBee library.
+//
+// GBee is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GBee is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#include <array>
+#include <cstdint>
+#include <gbee/gbee.hpp>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <vector>
+
+enum class Header
+{
+   Type,
+   Length
+};
+
+using namespace gbee;
+
+using HeaderGroup =
+  Group<Field<Header::Type, std::uint8_t>, LittleEndianField<Header::Length, std::uint16_t>>;
+
+using StreamFrame = FrameView<0, HeaderGroup>;
+
+static std::vector<std::uint8_t>
+make_stream(std::size_t frame_count)
+{
+   std::vector<std::uint8_t> stream;
+   for(std::size_t i = 0; i < frame_count; ++i) {
+      const std::size_t length{i % 7};
+      stream.push_back(static_cast<std::uint8_t>(i));
+      stream.push_back(static_cast<std::uint8_t>(length));
+      stream.push_back(0);
+      for(std::size_t j = 0; j < length; ++j) {
+         stream.push_back(static_cast<std::uint8_t>(i + j));
+      }
+   }
+   return stream;
+}
+
+struct Collector
+{
+   void
+   operator()(const StreamFrame& frame)
+   {
+      std::uint8_t type{0};
+      frame.extract<Header::Type>(type);
+      types.push_back(type);
+      const Span<const std::uint8_t> payload{frame.payload<Header::Length>()};
+      for(std::size_t j = 0; j < payload.size(); ++j) {
+         EXPECT_EQ(payload[j], static_cast<std::uint8_t>(type + j));
+      }
+   }
+
+   std::vector<std::uint8_t> types;
+};
+
+TEST(StreamParser, byte_by_byte)
+{
+   const std::vector<std::uint8_t> stream{make_stream(40)};
+   StreamParser<StreamFrame, Header::Length, 16> parser;
+   Collector collector;
+
+   for(const std::uint8_t byte : stream) {
+      ASSERT_EQ(parser.write(&byte, 1), 1);
+      parser.read(collector);
+   }
+   ASSERT_EQ(collector.types.size(), 40);
+   for(std::size_t i = 0; i < collector.types.size(); ++i) {
+      EXPECT_EQ(collector.types[i], i);
+   }
+   EXPECT_EQ(parser.available(), 0);
+}
+
+TEST(StreamParser, chunks_across_wrap)
+{
+   const std::vector<std::uint8_t> stream{make_stream(100)};
+   StreamParser<StreamFrame, Header::Length, 32> parser;
+   Collector collector;
+
+   std::size_t written{0};
+   while(written < stream.size()) {
+      const std::size_t chunk{std::min<std::size_t>(13, stream.size() - written)};
+      written += parser.write(stream.data() + written, chunk);
+      parser.read(collector);
+   }
+   EXPECT_EQ(collector.types.size(), 100);
+   EXPECT_EQ(parser.dropped(), 0);
+}
+
+TEST(StreamParser, partial_write_when_full)
+{
+   StreamParser<StreamFrame, Header::Length, 8> parser;
+   const std::array<std::uint8_t, 12> bytes{{1, 9, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}};
+   EXPECT_EQ(parser.write(bytes.data(), bytes.size()), 8);
+   EXPECT_EQ(parser.write(bytes.data(), bytes.size()), 0);
+   EXPECT_EQ(parser.available(), 8);
+}
+
+TEST(StreamParser, drop_oversized_length)
+{
+   StreamParser<StreamFrame, Header::Length, 16> parser;
+   const std::array<std::uint8_t, 6> bytes{{7, 0x20, 0x00, 0x00, 0x00, 0x00}};
+   parser.write(bytes.data(), bytes.size());
+
+   Collector collector;
+   EXPECT_EQ(parser.read(collector), 1);
+   EXPECT_EQ(parser.dropped(), 1);
+   EXPECT_EQ(parser.available(), 2);
+   EXPECT_THAT(collector.types, ::testing::ElementsAre(0x20));
+}
@@ -0,0 +1,134 @@
+//
+// Copyright (C) 2019 Tomasz Jankowski tomasz.jankowski.mail AT gmail.com>
+//
+// This is part of GBee library.
+//
+// GBee is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GBee is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#include <array>
+#include <cstdint>
+#include <gbee/gbee.hpp>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+enum class Header
+{
+   Control,
+   Sequence,
+   Hops,
+   Destination
+};
+
+enum class Inner
+{
+   Crc
+};
+
+enum class Trailer
+{
+   Fcs
+};
+
+using namespace gbee;
+
+using HeaderGroup = Group<LittleEndianField<Header::Control, std::uint16_t>,
+                          Field<Header::Sequence, std::uint8_t>,
+                          BitField<Header::Hops, std::uint8_t, 4>,
+                          BitField<Header::Destination, std::uint16_t, 12>>;
+
+using ForwardFrame = Frame<0, HeaderGroup, Group<Checksum<Trailer::Fcs, Crc16Kermit>>>;
+
+TEST(TrackedFrame, field_index)
+{
+   using Tracked = TrackedFrame<ForwardFrame, Trailer::Fcs>;
+   EXPECT_EQ(Tracked::field_count, 5);
+   EXPECT_EQ(Tracked::field_index<Header::Control>, 0);
+   EXPECT_EQ(Tracked::field_index<Header::Destination>, 3);
+   EXPECT_EQ(Tracked::field_index<Trailer::Fcs>, 4);
+}
+
+TEST(TrackedFrame, commit)
+{
+   std::array<std::uint8_t, ForwardFrame::size> buffer{};
+   ForwardFrame frame{buffer};
+   frame.inject<Header::Control>(std::uint16_t{0x8841});
+   frame.inject<Header::Sequence>(std::uint8_t{7});
+   frame.inject<Header::Hops>(std::uint8_t{3});
+   frame.inject<Header::Destination>(std::uint16_t{0xabc});
+   frame.update_checksum<Trailer::Fcs>();
+
+   TrackedFrame<ForwardFrame, Trailer::Fcs> tracked{frame};
+   EXPECT_FALSE(tracked.is_dirty());
+
+   tracked.inject<Header::Sequence>(std::uint8_t{8});
+   tracked.inject<Header::Hops>(std::uint8_t{2});
+   EXPECT_TRUE(tracked.is_dirty());
+   EXPECT_TRUE(tracked.is_dirty<Header::Hops>());
+   EXPECT_FALSE(tracked.is_dirty<Header::Control>());
+
+   std::uint8_t sequence{0};
+   tracked.extract<Header::Sequence>(sequence);
+   EXPECT_EQ(sequence, 8);
+   frame.extract<Header::Sequence>(sequence);
+   EXPECT_EQ(sequence, 7);
+
+   tracked.commit();
+   EXPECT_FALSE(tracked.is_dirty());
+   EXPECT_TRUE(frame.verify_checksum<Trailer::Fcs>());
+
+   std::uint8_t hops{0};
+   frame.extract<Header::Hops>(hops);
+   EXPECT_EQ(hops, 2);
+   std::uint16_t destination{0};
+   frame.extract<Header::Destination>(destination);
+   EXPECT_EQ(destination, 0xabc);
+
+   auto expected{buffer};
+   ForwardFrame{expected}.update_checksum<Trailer::Fcs>();
+   EXPECT_EQ(buffer, expected);
+}
+
+TEST(TrackedFrame, discard)
+{
+   std::array<std::uint8_t, ForwardFrame::size> buffer{};
+   TrackedFrame<ForwardFrame, Trailer::Fcs> tracked{ForwardFrame{buffer}};
+   tracked.inject<Header::Control>(std::uint16_t{0xffff});
+   tracked.discard();
+   tracked.commit();
+   EXPECT_THAT(buffer, ::testing::Each(0));
+}
+
+TEST(TrackedFrame, several_checksums)
+{
+   using NestedFrame = Frame<0,
+                             Group<Checksum<Inner::Crc, Crc16Kermit,
+                                            FieldRange<Header::Control, Header::Sequence>>>,
+                             HeaderGroup,
+                             Group<Checksum<Trailer::Fcs, Crc32c,
+                                            FieldRange<Header::Hops, Header::Destination>>>>;
+
+   std::array<std::uint8_t, NestedFrame::size> buffer{};
+   NestedFrame frame{buffer};
+   frame.update_checksum<Inner::Crc>();
+   frame.update_checksum<Trailer::Fcs>();
+
+   TrackedFrame<NestedFrame, Inner::Crc, Trailer::Fcs> tracked{frame};
+   tracked.inject<Header::Control>(std::uint16_t{0x1234});
+   tracked.inject<Header::Destination>(std::uint16_t{0x321});
+   tracked.commit();
+
+   EXPECT_TRUE(frame.verify_checksum<Inner::Crc>());
+   EXPECT_TRUE(frame.verify_checksum<Trailer::Fcs>());
+}